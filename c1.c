@@ -10,11 +10,31 @@
 #include <string.h>
 #include <ctype.h>
 #include <time.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include <unistd.h> // For sleep() on Unix-like systems
 
+// For memory-mapped, multithreaded bulk import on Unix-like systems
+#ifndef _WIN32
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 // For Windows compatibility with sleep()
 #ifdef _WIN32
 #include <windows.h>
+// The reentrant time conversions use the MSVC names (and argument order) on Windows
+#define localtime_r(t, tm) (localtime_s((tm), (t)) == 0 ? (tm) : NULL)
+#define gmtime_r(t, tm) (gmtime_s((tm), (t)) == 0 ? (tm) : NULL)
+#endif
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
 #endif
 
 // =============================
@@ -31,8 +51,96 @@
 #define MIN_TEMP -50.0
 #define MAX_TEMP 50.0
 #define MAX_FAVORITES 20
+#define MAX_RATINGS 100
 #define NUM_SEASONS 4
 #define NUM_SPECIAL_EVENTS 5
+#define NUM_CITY_REGIONS 64
+#define HEMISPHERE_NORTH 0
+#define HEMISPHERE_SOUTH 1
+#define DST_NONE 0               // Indexes into dst_rules[]
+#define DST_EU 1
+#define DST_US 2
+#define DST_AU 3
+#define DST_NZ 4
+#define DST_CHILE 5
+#define NUM_DST_RULES 6
+#define NUM_CATEGORIES 3
+#define MAX_IMPORT_THREADS 64
+#define NUM_CONDITIONS 6
+#define MAX_CLIMATE_CITIES 128
+#define CLIMATE_CITY_LEN 32
+#define CLIMATE_CELLS_PER_CITY (12 * 24)
+#define CLIMATE_HASH_SLOTS 256
+#define CLIMATE_VERSION 1
+#define CLIMATE_FILE "climate.bin"
+#define EVENT_RING_SIZE 8192            // Must be a power of two
+#define EVENT_BATCH_SIZE 512
+#define EVENT_TEXT_LEN (MAX_LEN * 2)
+#define EVENT_SEGMENT_BYTES (8 * 1024 * 1024)
+#define EVENT_LOG_PREFIX "events"
+#define EVENT_FEEDBACK 1
+#define EVENT_RECOMMENDATION 2
+#define EVENT_RATING 3
+#define EVENT_FAVORITE_ADDED 4
+#define EVENT_FAVORITE_REMOVED 5
+#define SNAPSHOT_FILE "outfit_state.snap"
+#define SNAPSHOT_VERSION 3
+#define SNAPSHOT_PAGE_SIZE 4096
+#define SNAPSHOT_SECTIONS 8
+#define SNAP_HISTORY 0
+#define SNAP_RATINGS 1
+#define SNAP_FAVORITES 2
+#define SNAP_OUTFITS 3
+#define SNAP_ACCESSORIES 4
+#define SNAP_SHOES 5
+#define SNAP_JACKETS 6
+#define SNAP_WARDROBE 7
+#define MAX_DICT_ENTRIES 4096
+#define DICT_HASH_SLOTS 8192
+#define ANALYTICS_BLOCK 1024
+#define ANALYTICS_MIN_ROWS_PER_THREAD 1000000
+#define QUERY_JACKETS_BY_CONDITION_MONTH 1
+#define QUERY_AVG_TEMP_BY_OUTFIT 2
+#define QUERY_MOOD_BY_CATEGORY 3
+#define ITEM_OUTFIT 0
+#define ITEM_ACCESSORY 1
+#define ITEM_SHOE 2
+#define ITEM_JACKET 3
+#define NUM_ITEM_KINDS 4
+#define CATALOG_ITEMS (NUM_CATEGORIES * (NUM_OUTFITS + NUM_ACCESSORIES + NUM_SHOES + NUM_JACKETS))
+#define ITEM_SET_WORDS ((CATALOG_ITEMS + 63) / 64)
+#define NUM_STYLES 4
+#define STYLE_FORMAL 0
+#define STYLE_CASUAL 1
+#define STYLE_ACTIVE 2
+#define STYLE_OUTDOOR 3
+#define MAX_ACTIVE_EVENTS 50
+#define EVENT_CALENDAR_FILE "events.csv"
+#define COLD_SEGMENT_ROWS 4096   // Evicted entries per sealed cold segment
+#define COLD_FIELDS 11           // Dictionary-encoded string fields per entry
+#define COLD_SEGMENT_VERSION 1
+#define COLD_SEGMENT_PREFIX "history"
+#define COLD_STAGING_FILE "history-staging.dat"
+#define COLD_STAGING_VERSION 1
+#define HISTORY_FIELD_OUTFIT 0   // Field numbers of HistoryRow.fields
+#define HISTORY_FIELD_JACKET 6
+#define HISTORY_FIELD_CITY 7
+#define HISTORY_FIELD_CONDITION 8
+#define HISTORY_FIELD_MOOD 10
+#define LZ_HASH_BITS 12
+#define WEAR_COOLDOWN_DAYS 1   // Items worn this recently (today/yesterday) are skipped
+#define MAX_GROUP_SIZE 1000
+#define CATALOG_FILE "catalog.csv"
+#define MAX_CATALOG_READERS 64   // Threads that may hold catalog read sections
+#define CATALOG_POLL_MS 500      // How often the watcher checks CATALOG_FILE
+#define PAGE_SIZE 5              // Records per screen in paginated views
+#define FILTER_DATES 1
+#define FILTER_STARS 2
+#define FILTER_CITY 4
+#define PALETTE_COLORS 3
+#define GROUP_DISTINCT_JACKETS 1 // Spread jackets so as few members as possible share one
+#define GROUP_MATCHING_OUTFIT 2  // Everyone wears the same outfit
+#define GROUP_SHARED_PALETTE 4   // Colors come from one palette for the weather
 
 // ANSI color codes for terminal UI
 #define GREEN   "\033[1;32m"
@@ -66,6 +174,7 @@ typedef struct {
     Weather weather;
     char user_note[MAX_LEN]; // User note feature
     char mood[MAX_LEN];      // NEW FEATURE: mood field in history
+    int64_t timestamp;       // Unix seconds when the outfit was recommended
 } HistoryEntry;
 
 typedef struct {
@@ -90,6 +199,285 @@ typedef struct {
     char color_scheme[MAX_LEN];
 } SpecialEvent;
 
+typedef struct {
+    const char *city;
+    int utc_offset_min;  // Standard-time offset from UTC in minutes
+    int hemisphere;      // HEMISPHERE_NORTH or HEMISPHERE_SOUTH
+    int dst;             // DST_* rule, DST_NONE if clocks never change
+} CityRegion;
+
+// Daylight saving time: one hour ahead from the start Sunday to the end
+// Sunday (a southern rule starts late in the year and ends the next one)
+typedef struct {
+    int start_month;     // 1-12
+    int start_day;       // Switch on the first Sunday on or after this day, -1 for the last Sunday
+    int start_hour;      // Switch time, see utc
+    int end_month;
+    int end_day;
+    int end_hour;
+    int utc;             // 1 if the hours are UTC, 0 if local standard time
+} DstRule;
+
+// Receives each imported record; worker identifies the calling import thread
+typedef void (*WeatherSink)(const Weather *weather, time_t timestamp, int worker, void *user);
+
+typedef struct {
+    long long records;   // Rows delivered to the sink
+    long long rejected;  // Malformed or out-of-range rows
+    long long bytes;
+    int workers;
+    double seconds;
+} ImportStats;
+
+// One city x month x hour cell of the climatology table (stored on disk as-is)
+typedef struct {
+    float temp_min;
+    float temp_max;
+    float temp_mean;
+    uint32_t samples;   // 0 if the cell was filled in from a neighbouring hour
+    uint8_t valid;
+    uint8_t condition;  // Dominant condition, index into conditions[]
+    uint8_t category;   // Index into categories[]
+    uint8_t outfit;     // Precomputed best picks within that category
+    uint8_t accessory;
+    uint8_t shoe;
+    uint8_t jacket;
+    uint8_t reserved;
+} ClimateCell;
+
+typedef struct {
+    char magic[8];         // "CLIMATE\0"
+    uint32_t version;
+    uint32_t city_count;
+    uint32_t cells_offset; // Byte offset of the first ClimateCell
+    uint32_t file_size;
+} ClimateHeader;
+
+typedef struct {
+    char name[CLIMATE_CITY_LEN]; // Sorted case-insensitively for binary search
+} ClimateCity;
+
+// A loaded (memory-mapped) climatology file
+typedef struct {
+    const ClimateHeader *header;
+    const ClimateCity *cities;
+    const ClimateCell *cells;
+    void *data;
+    size_t size;
+} ClimateTable;
+
+// Structured event for the asynchronous event log
+typedef struct {
+    int type;                     // One of the EVENT_* constants
+    int value;                    // Stars for ratings, list index for favorites
+    int64_t timestamp;
+    char subject[MAX_LEN];        // Outfit title, or empty
+    char text[EVENT_TEXT_LEN];    // Feedback, note or weather summary
+} Event;
+
+typedef struct {
+    long long logged;        // Events handed to the writer
+    long long written;       // Events persisted to a segment
+    long long dropped;       // Ring full, log stopped, or the segment write failed
+    long long backpressure;  // Pushes that found the ring over 3/4 full
+    long long bytes;
+    int segment;             // Current segment number
+} EventLogStats;
+
+// Snapshot sections hold plain structs at page-aligned file offsets
+typedef struct {
+    uint32_t offset;     // Bytes from the start of the file
+    uint32_t count;      // Elements stored (the array capacity)
+    uint32_t elem_size;
+    uint32_t checksum;   // FNV-1a of the section bytes
+} SnapshotSection;
+
+typedef struct {
+    char magic[8];        // "OUTFITS\0"
+    uint32_t version;
+    uint32_t page_size;
+    uint64_t generation;
+    int64_t created;
+    uint32_t history_count;
+    uint32_t rating_count;
+    uint32_t favorite_count;
+    uint32_t section_count;
+    SnapshotSection sections[SNAPSHOT_SECTIONS];
+    uint32_t header_checksum; // FNV-1a of every header byte before this field
+} SnapshotHeader;
+
+// String dictionary: maps item names to dense 16-bit IDs
+typedef struct {
+    char (*names)[MAX_LEN];
+    uint16_t slots[DICT_HASH_SLOTS]; // ID + 1, 0 when empty
+    int count;
+} Dictionary;
+
+// History in columnar form: one array per field, row i across all of them
+typedef struct {
+    size_t count;
+    size_t capacity;
+    int32_t *day;        // Local days since 1970-01-01
+    float *temp;
+    uint16_t *outfit;    // IDs in outfit_dict
+    uint16_t *jacket;    // IDs in jacket_dict
+    uint16_t *mood;      // IDs in mood_dict
+    uint8_t *month;      // 0-11
+    uint8_t *condition;  // Index into conditions[]
+    uint8_t *category;   // Index into categories[]
+} HistoryColumns;
+
+// Group-by result; the group index layout depends on the query kind
+typedef struct {
+    int kind;
+    int groups;
+    uint64_t *counts;
+    double *sums;        // QUERY_AVG_TEMP_BY_OUTFIT only
+} QueryResult;
+
+// A dated or yearly-recurring event in the calendar
+typedef struct {
+    SpecialEvent info;   // Name, description, outfit idea and colors
+    int style;           // STYLE_* used to pick the outfit
+    int recurring;       // 1 if the dates repeat every year
+} CalendarEvent;
+
+// [start, end] day range of one event (both inclusive)
+typedef struct {
+    int32_t start;
+    int32_t end;
+    int event;           // Index into calendar_events
+} EventInterval;
+
+// Intervals sorted by start, with max_end[mid] holding the largest end in
+// the implicit binary-search subtree rooted at mid
+typedef struct {
+    EventInterval *items;
+    int32_t *max_end;
+    int count;
+    int capacity;
+    int dirty;           // Needs re-sorting before the next query
+} IntervalIndex;
+
+// On-disk header of an immutable cold history segment; the LZ-compressed
+// body follows directly after it
+typedef struct {
+    char magic[8];       // "HISTSEG\0"
+    uint32_t version;
+    uint32_t rows;
+    int64_t min_timestamp;
+    int64_t max_timestamp;
+    uint32_t raw_size;   // Encoded size before compression
+    uint32_t comp_size;
+} ColdSegmentHeader;
+
+// In-memory index entry for a cold segment (its min/max lets scans skip it)
+typedef struct {
+    int number;          // history-NNNNNN.seg
+    uint32_t rows;
+    int64_t min_timestamp;
+    int64_t max_timestamp;
+    uint32_t raw_size;
+    uint32_t comp_size;
+} ColdSegment;
+
+// Header of COLD_STAGING_FILE; the staged HistoryEntry records follow it
+typedef struct {
+    char magic[8];       // "HISTSTG\0"
+    uint32_t version;
+    int32_t segment;     // Number the staged entries will be sealed as
+    int32_t absorbed;    // 1 if that segment was a short one folded back into staging
+    uint32_t reserved;
+} ColdStagingHeader;
+
+// A history entry seen through its columns: the strings point into a
+// decoded segment (or into the entry), so no HistoryEntry is rebuilt
+typedef struct {
+    int64_t timestamp;
+    float temp;
+    const char *fields[COLD_FIELDS]; // HISTORY_FIELD_* order
+} HistoryRow;
+
+// Packed set of catalog item IDs (see catalog_item_id())
+typedef struct {
+    uint64_t words[ITEM_SET_WORDS];
+} ItemSet;
+
+// Per-user inventory and wear tracking for every catalog item
+typedef struct {
+    ItemSet owned;
+    ItemSet laundry;
+    ItemSet worn_recently;          // Derived from last_worn_day, rebuilt once per day
+    int32_t recent_day;             // Day worn_recently was computed for
+    uint32_t wear_count[CATALOG_ITEMS];
+    int32_t last_worn_day[CATALOG_ITEMS]; // Days since 1970-01-01, 0 if never worn
+} Wardrobe;
+
+// One published version of the outfit catalog. Shapes are fixed so item
+// IDs, wardrobes and snapshots stay valid across reloads.
+typedef struct Catalog {
+    uint32_t version;
+    Outfit outfits[NUM_CATEGORIES][NUM_OUTFITS];
+    char accessories[NUM_CATEGORIES][NUM_ACCESSORIES][MAX_LEN];
+    char shoes[NUM_CATEGORIES][NUM_SHOES][MAX_LEN];
+    char jackets[NUM_CATEGORIES][NUM_JACKETS][MAX_LEN];
+    struct Catalog *retired_next;  // Reclamation list (watcher thread only)
+    uint64_t retired_epoch;
+} Catalog;
+
+// One person in a group request
+typedef struct {
+    char name[MAX_LEN];
+    Wardrobe *wardrobe;   // NULL when everything in the catalog is available
+} GroupMember;
+
+// Planned outfit for one group member (indices within the weather category)
+typedef struct {
+    int outfit;
+    int accessory;
+    int shoe;
+    int jacket;
+    const char *color;    // Palette color, NULL without GROUP_SHARED_PALETTE
+    int compromised;      // 1 when any assigned item is one the member lacks (or cannot wear today)
+} GroupAssignment;
+
+// Filters for paginated views; a store ignores fields it has no data for
+typedef struct {
+    int32_t from_day;     // Inclusive range in days since 1970-01-01
+    int32_t to_day;
+    int min_stars;        // 0 for any
+    char city[MAX_LEN];   // Empty for any
+} RecordFilter;
+
+// Stable position in a store for paginated views
+typedef struct {
+    int64_t key;          // History: timestamp to continue from; ratings and favorites: array index
+    int skip;             // History: records at exactly key that were already passed
+    int end;              // Nothing after this position
+} PageCursor;
+
+// Renders up to page_size records from *at that pass *filter and sets
+// *next to the position after them; returns the number rendered
+typedef int (*PageRenderer)(const PageCursor *at, const RecordFilter *filter, int page_size, int first_number, PageCursor *next);
+
+typedef struct {
+    const char *title;
+    PageRenderer render;
+    PageCursor start;
+    int filters;               // FILTER_* fields the store has
+    const char *action_label;  // Extra menu entry, NULL for none
+    int64_t (*action)();       // Runs the extra entry and returns the key of a record it
+                               // removed (index-keyed views), else -1; the page is rendered again
+} PagedView;
+
+// Date context computed once per request (or per batch) by the clock service
+typedef struct {
+    time_t now;                 // Clock reading the context was built from
+    struct tm local;            // Broken-down time for the active region
+    int season;                 // Index into seasons[]
+    const CityRegion *region;   // NULL when the system timezone is used
+} DateContext;
+
 // =============================
 // GLOBAL DATA ARRAYS
 // =============================
@@ -110,183 +498,4049 @@ Outfit moderate_outfits[NUM_OUTFITS] = {
     {"Neutral Trend", {"Sweatshirt", "Cuffed Pants", "Layered Tee"}}
 };
 
-Outfit hot_outfits[NUM_OUTFITS] = {
-    {"Summer Cool", {"Linen Shirt", "Cotton Shorts", "Baseball Cap"}},
-    {"Beach Ready", {"Tank Top", "Board Shorts", "Sun Hat"}},
-    {"City Heat", {"Breathable Tee", "Linen Pants", "Cooling Towel"}},
-    {"Tropical Explorer", {"Short Sleeve Shirt", "Cargos", "Sun Bandana"}},
-    {"Resort Comfort", {"Sleeveless Top", "Jersey Shorts", "Visor"}}
-};
+Outfit hot_outfits[NUM_OUTFITS] = {
+    {"Summer Cool", {"Linen Shirt", "Cotton Shorts", "Baseball Cap"}},
+    {"Beach Ready", {"Tank Top", "Board Shorts", "Sun Hat"}},
+    {"City Heat", {"Breathable Tee", "Linen Pants", "Cooling Towel"}},
+    {"Tropical Explorer", {"Short Sleeve Shirt", "Cargos", "Sun Bandana"}},
+    {"Resort Comfort", {"Sleeveless Top", "Jersey Shorts", "Visor"}}
+};
+
+char cold_accessories[NUM_ACCESSORIES][MAX_LEN] = {"Wool Scarf", "Insulated Gloves", "Warm Beanie", "Fleece Headband", "Thermal Socks"};
+char moderate_accessories[NUM_ACCESSORIES][MAX_LEN] = {"Baseball Cap", "Stylish Watch", "Leather Belt", "Sunglasses", "Light Scarf"};
+char hot_accessories[NUM_ACCESSORIES][MAX_LEN] = {"Wide-Brim Hat", "Cooling Bandana", "UV Wristband", "Portable Fan", "Sweat Towel"};
+
+char cold_shoes[NUM_SHOES][MAX_LEN] = {"Waterproof Boots", "Insulated Sneakers", "Warm Chelsea Boots", "Snow Boots", "Thermal Loafers"};
+char moderate_shoes[NUM_SHOES][MAX_LEN] = {"Comfortable Sneakers", "Canvas Shoes", "Casual Loafers", "Walking Boots", "Slip-ons"};
+char hot_shoes[NUM_SHOES][MAX_LEN] = {"Breathable Sandals", "Flip-Flops", "Mesh Sneakers", "Water Shoes", "Ventilated Slip-ons"};
+
+char cold_jackets[NUM_JACKETS][MAX_LEN] = {"Thermal Jacket", "Wool Jacket", "Insulated Coat", "Snow Parka", "Thick Hoodie"};
+char moderate_jackets[NUM_JACKETS][MAX_LEN] = {"Bomber Jacket", "Fleece Jacket", "Blazer", "Windbreaker", "Thin Hoodie"};
+char hot_jackets[NUM_JACKETS][MAX_LEN] = {"Mesh Jacket", "Light Hoodie", "Open Shirt", "Sport Vest", "Cotton Kimono"};
+
+// User state is reached through pointers so a loaded snapshot can be used in place
+HistoryEntry history_store[MAX_HISTORY];
+HistoryEntry *history = history_store;
+int history_count = 0;
+
+OutfitRating rating_store[MAX_RATINGS];  // Store up to MAX_RATINGS ratings
+OutfitRating *ratings = rating_store;
+int rating_count = 0;
+
+FavoriteOutfit favorite_store[MAX_FAVORITES];
+FavoriteOutfit *favorites = favorite_store;
+int favorite_count = 0;
+
+const char *categories[NUM_CATEGORIES] = {"cold", "moderate", "hot"};
+const char *conditions[NUM_CONDITIONS] = {"Sunny", "Rainy", "Cloudy", "Snowy", "Windy", "Mixed"};
+
+// Default {outfit, accessory, shoe, jacket} per category and condition,
+// used for climatology cells when no ratings favour another outfit
+const unsigned char condition_picks[NUM_CATEGORIES][NUM_CONDITIONS][4] = {
+    { {4, 0, 2, 1}, {0, 1, 0, 2}, {2, 2, 1, 0}, {1, 2, 3, 3}, {3, 0, 0, 2}, {2, 0, 1, 0} }, // cold
+    { {2, 3, 1, 0}, {0, 0, 3, 3}, {4, 1, 0, 1}, {1, 4, 3, 1}, {1, 4, 0, 3}, {0, 1, 0, 0} }, // moderate
+    { {1, 0, 0, 2}, {3, 1, 3, 0}, {2, 2, 2, 1}, {0, 1, 2, 1}, {3, 1, 2, 3}, {0, 0, 0, 2} }  // hot
+};
+// Coordinated palettes per condition (see suggest_color_style())
+const char *condition_palettes[NUM_CONDITIONS][PALETTE_COLORS] = {
+    {"Yellow", "Turquoise", "White"}, {"Olive", "Brown", "Navy"}, {"Orange", "Coral", "Cream"},
+    {"White", "Ice Blue", "Silver"}, {"Navy", "Grey", "Beige"}, {"Beige", "Grey", "Navy"}
+};
+const char *seasons[NUM_SEASONS] = {"Spring", "Summer", "Fall", "Winter"};
+
+// Season index (into seasons[]) for each month, per hemisphere
+const int season_table[2][12] = {
+    {3, 3, 0, 0, 0, 1, 1, 1, 2, 2, 2, 3}, // Northern: Dec-Feb winter, Jun-Aug summer
+    {1, 1, 2, 2, 2, 3, 3, 3, 0, 0, 0, 1}  // Southern: Dec-Feb summer, Jun-Aug winter
+};
+
+const DstRule dst_rules[NUM_DST_RULES] = {
+    {0, 0, 0, 0, 0, 0, 0},     // DST_NONE
+    {3, -1, 1, 10, -1, 1, 1},  // DST_EU: last Sunday of March to last Sunday of October, 01:00 UTC
+    {3, 8, 2, 11, 1, 1, 0},    // DST_US: second Sunday of March to first Sunday of November
+    {10, 1, 2, 4, 1, 2, 0},    // DST_AU: first Sunday of October to first Sunday of April
+    {9, -1, 2, 4, 1, 2, 0},    // DST_NZ: last Sunday of September to first Sunday of April
+    {9, 2, 4, 4, 2, 3, 1}      // DST_CHILE: first Sunday after September 1st to first Sunday after April 1st
+};
+
+CityRegion city_regions[NUM_CITY_REGIONS] = {
+    {"London", 0, HEMISPHERE_NORTH, DST_EU},          {"Dublin", 0, HEMISPHERE_NORTH, DST_EU},
+    {"Lisbon", 0, HEMISPHERE_NORTH, DST_EU},          {"Paris", 60, HEMISPHERE_NORTH, DST_EU},
+    {"Berlin", 60, HEMISPHERE_NORTH, DST_EU},         {"Madrid", 60, HEMISPHERE_NORTH, DST_EU},
+    {"Rome", 60, HEMISPHERE_NORTH, DST_EU},           {"Amsterdam", 60, HEMISPHERE_NORTH, DST_EU},
+    {"Brussels", 60, HEMISPHERE_NORTH, DST_EU},       {"Vienna", 60, HEMISPHERE_NORTH, DST_EU},
+    {"Stockholm", 60, HEMISPHERE_NORTH, DST_EU},      {"Warsaw", 60, HEMISPHERE_NORTH, DST_EU},
+    {"Athens", 120, HEMISPHERE_NORTH, DST_EU},        {"Helsinki", 120, HEMISPHERE_NORTH, DST_EU},
+    {"Istanbul", 180, HEMISPHERE_NORTH, DST_NONE},    {"Moscow", 180, HEMISPHERE_NORTH, DST_NONE},
+    {"Lagos", 60, HEMISPHERE_NORTH, DST_NONE},        {"Nairobi", 180, HEMISPHERE_SOUTH, DST_NONE},
+    {"Johannesburg", 120, HEMISPHERE_SOUTH, DST_NONE},{"Cape Town", 120, HEMISPHERE_SOUTH, DST_NONE},
+    {"Dubai", 240, HEMISPHERE_NORTH, DST_NONE},       {"Karachi", 300, HEMISPHERE_NORTH, DST_NONE},
+    {"Delhi", 330, HEMISPHERE_NORTH, DST_NONE},       {"Mumbai", 330, HEMISPHERE_NORTH, DST_NONE},
+    {"Bangkok", 420, HEMISPHERE_NORTH, DST_NONE},     {"Jakarta", 420, HEMISPHERE_SOUTH, DST_NONE},
+    {"Singapore", 480, HEMISPHERE_NORTH, DST_NONE},   {"Hong Kong", 480, HEMISPHERE_NORTH, DST_NONE},
+    {"Beijing", 480, HEMISPHERE_NORTH, DST_NONE},     {"Shanghai", 480, HEMISPHERE_NORTH, DST_NONE},
+    {"Manila", 480, HEMISPHERE_NORTH, DST_NONE},      {"Tokyo", 540, HEMISPHERE_NORTH, DST_NONE},
+    {"Seoul", 540, HEMISPHERE_NORTH, DST_NONE},       {"Perth", 480, HEMISPHERE_SOUTH, DST_NONE},
+    {"Darwin", 570, HEMISPHERE_SOUTH, DST_NONE},      {"Adelaide", 570, HEMISPHERE_SOUTH, DST_AU},
+    {"Brisbane", 600, HEMISPHERE_SOUTH, DST_NONE},    {"Sydney", 600, HEMISPHERE_SOUTH, DST_AU},
+    {"Melbourne", 600, HEMISPHERE_SOUTH, DST_AU},     {"Hobart", 600, HEMISPHERE_SOUTH, DST_AU},
+    {"Auckland", 720, HEMISPHERE_SOUTH, DST_NZ},      {"Wellington", 720, HEMISPHERE_SOUTH, DST_NZ},
+    {"Honolulu", -600, HEMISPHERE_NORTH, DST_NONE},   {"Anchorage", -540, HEMISPHERE_NORTH, DST_US},
+    {"Los Angeles", -480, HEMISPHERE_NORTH, DST_US},  {"San Francisco", -480, HEMISPHERE_NORTH, DST_US},
+    {"Seattle", -480, HEMISPHERE_NORTH, DST_US},      {"Vancouver", -480, HEMISPHERE_NORTH, DST_US},
+    {"Denver", -420, HEMISPHERE_NORTH, DST_US},       {"Phoenix", -420, HEMISPHERE_NORTH, DST_NONE},
+    {"Chicago", -360, HEMISPHERE_NORTH, DST_US},      {"Mexico City", -360, HEMISPHERE_NORTH, DST_NONE},
+    {"New York", -300, HEMISPHERE_NORTH, DST_US},     {"Boston", -300, HEMISPHERE_NORTH, DST_US},
+    {"Washington", -300, HEMISPHERE_NORTH, DST_US},   {"Miami", -300, HEMISPHERE_NORTH, DST_US},
+    {"Toronto", -300, HEMISPHERE_NORTH, DST_US},      {"Montreal", -300, HEMISPHERE_NORTH, DST_US},
+    {"Bogota", -300, HEMISPHERE_NORTH, DST_NONE},     {"Lima", -300, HEMISPHERE_SOUTH, DST_NONE},
+    {"Santiago", -240, HEMISPHERE_SOUTH, DST_CHILE},  {"Buenos Aires", -180, HEMISPHERE_SOUTH, DST_NONE},
+    {"Sao Paulo", -180, HEMISPHERE_SOUTH, DST_NONE},  {"Rio de Janeiro", -180, HEMISPHERE_SOUTH, DST_NONE}
+};
+
+DateContext date_ctx;  // Shared date context for the current request
+
+HistoryColumns history_columns;  // Analytics copy of every history entry
+
+Catalog catalog_store;                          // First catalog version (compiled-in or from the snapshot)
+_Atomic(Catalog *) live_catalog = &catalog_store; // Read through catalog_enter()/current_catalog()
+
+Wardrobe wardrobe_store;
+Wardrobe *wardrobe = &wardrobe_store;  // Current user's wardrobe (may live in the snapshot)
+ItemSet weather_valid_items[NUM_CATEGORIES]; // Catalog items suited to each category
+const int item_kind_count[NUM_ITEM_KINDS] = {NUM_OUTFITS, NUM_ACCESSORIES, NUM_SHOES, NUM_JACKETS};
+const int item_kind_offset[NUM_ITEM_KINDS] = {
+    0,
+    NUM_CATEGORIES * NUM_OUTFITS,
+    NUM_CATEGORIES * (NUM_OUTFITS + NUM_ACCESSORIES),
+    NUM_CATEGORIES * (NUM_OUTFITS + NUM_ACCESSORIES + NUM_SHOES)
+};
+const char *item_kind_names[NUM_ITEM_KINDS] = {"Outfits", "Accessories", "Shoes", "Jackets"};
+
+ColdSegment *cold_segments = NULL;    // Oldest first
+int cold_segment_count = 0;
+int cold_segment_capacity = 0;
+HistoryEntry *cold_staging = NULL;     // Evicted entries waiting to be sealed
+int cold_staging_count = 0;
+int cold_staging_segment = 1;          // Number the staged entries will be sealed as
+int cold_staging_durable = 0;          // Mirror staging to COLD_STAGING_FILE (off for benchmarks)
+char cold_segment_prefix[MAX_LEN] = COLD_SEGMENT_PREFIX; // Segments are <prefix>-NNNNNN.seg
+
+CalendarEvent *calendar_events = NULL;
+int calendar_event_count = 0;
+int calendar_event_capacity = 0;
+IntervalIndex dated_event_index;   // Absolute day numbers
+IntervalIndex yearly_event_index;  // Day of a leap year (0-365), for recurring events
+
+const char *style_names[NUM_STYLES] = {"formal", "casual", "active", "outdoor"};
+// Preferred outfit index per weather category and style
+const int style_outfits[NUM_CATEGORIES][NUM_STYLES] = {
+    {2, 0, 3, 1}, // cold: Cozy Professional, Winter Warrior, Mountain Hiker, Arctic Explorer
+    {3, 1, 2, 4}, // moderate: Business Breeze, Weekend Relaxed, Urban Explorer, Neutral Trend
+    {2, 4, 3, 1}  // hot: City Heat, Resort Comfort, Tropical Explorer, Beach Ready
+};
+// Yearly dates (MM-DD) and style for the built-in special_events
+const char *special_event_dates[NUM_SPECIAL_EVENTS][2] = {
+    {"12-15", "01-01"}, {"06-01", "08-31"}, {"09-20", "10-31"}, {"04-01", "05-31"}, {"12-01", "03-01"}
+};
+const int special_event_styles[NUM_SPECIAL_EVENTS] = {STYLE_FORMAL, STYLE_OUTDOOR, STYLE_CASUAL, STYLE_CASUAL, STYLE_ACTIVE};
+Dictionary outfit_dict, jacket_dict, mood_dict;
+
+ClimateTable climate;  // Loaded climatology, empty if no file was found
+SpecialEvent special_events[NUM_SPECIAL_EVENTS] = {
+    {"Holiday Party", "Festive gathering with family and friends", 
+     "Elegant dress or suit with seasonal accessories", 
+     "Rich reds, deep greens, and metallic accents"},
+    {"Beach Day", "Perfect for summer relaxation", 
+     "Light, breathable fabrics with UV protection", 
+     "Bright colors and tropical patterns"},
+    {"Fall Festival", "Outdoor celebration with seasonal activities", 
+     "Layered clothing with comfortable footwear", 
+     "Warm earth tones and autumn colors"},
+    {"Spring Garden Party", "Outdoor social gathering", 
+     "Light layers with floral patterns", 
+     "Pastel colors and fresh spring tones"},
+    {"Winter Sports Day", "Active outdoor winter activities", 
+     "Thermal layers with waterproof outerwear", 
+     "Bright colors for visibility in snow"}
+};
+
+// =============================
+// FUNCTION DECLARATIONS
+// =============================
+
+void print_banner();
+void display_greeting(); // Consolidated greeting function
+void display_seasonal_tip(); // New function declaration
+void strip_newline(char *str);
+int compare_names_ci(const char *a, const char *b);
+void wait_for_user();
+int get_valid_choice(int max);
+void get_weather_input(Weather *weather);
+const char* get_category(float temp);
+void simulate_loading(const char *msg);
+void display_outfits(Outfit outfits[], int size);
+void display_options(char options[][MAX_LEN], int count);
+void recommend_outfit(const Weather *weather);
+void show_weather_tips(const char *condition);
+void suggest_color_style(const char *condition); // Part of main branch features
+void give_temperature_advice(float temp); // Part of main branch features
+void secret_feature(); // Part of main branch features
+void check_for_secret_code(); // Part of main branch features
+void show_help_section(); // Part of main branch features
+void main_menu(); // Part of main branch features
+void get_user_note(char *note); // User note feature
+void get_user_mood(char *mood); // NEW FEATURE: mood input
+void save_history(Outfit o, Weather w, const char *a, const char *s, const char *j, const char *user_note, const char *mood); // Updated
+void print_history_entry(const HistoryEntry *h, int number);
+void show_history();
+void print_divider();
+void repeat_menu();
+void farewell();
+void rate_outfit(const char *outfit_name); // New rating feature
+void show_ratings(); // New rating feature
+void display_fashion_affirmation(); // New minor feature
+
+void add_to_favorites(const Outfit *outfit, const char *accessory, const char *shoe, const char *jacket);
+void show_favorites();
+void remove_favorite(int index);
+int64_t prompt_remove_favorite();
+void show_seasonal_suggestions();
+const char* get_current_season();
+void suggest_special_event_outfit();
+
+void get_general_feedback(); // NEW FEATURE: General feedback function
+void display_random_tip(); // NEW FEATURE: Random tip function
+
+// Clock and calendar service
+time_t clock_now();
+void set_clock_source(time_t (*source)(void));
+void set_fixed_clock(time_t t);
+const CityRegion* find_city_region(const char *city);
+void build_date_context(time_t t, const char *city, DateContext *ctx);
+void refresh_date_context(const char *city);
+
+// Bulk import of historical observations
+int get_category_index(float temp);
+long long days_from_civil(int year, int month, int day);
+int days_in_month(int year, int month);
+double monotonic_seconds();
+int import_weather_csv(const char *path, WeatherSink sink, void *user, ImportStats *stats);
+int run_bulk_import(const char *path);
+
+// Climatology table
+int get_condition_index(const char *condition);
+int build_climate_table(const char *csv_path, const char *out_path);
+int load_climate_table(const char *path);
+const ClimateCell* lookup_climate(const char *city, time_t t);
+void show_climate_default(const char *city);
+
+// Asynchronous event log
+int event_log_start(const char *prefix);
+void event_log_stop();
+int log_event(int type, int value, const char *subject, const char *text);
+EventLogStats event_log_stats();
+int make_scratch_dir(char *dir, size_t size);
+void remove_scratch_dir(const char *dir);
+int run_event_benchmark(long long count);
+
+// State snapshots
+int save_snapshot(const char *path);
+int save_snapshot_async(const char *path);
+void wait_for_snapshot();
+int load_snapshot(const char *path);
+int verify_snapshot(const char *path);
+
+// Columnar history analytics
+int dict_encode(Dictionary *dict, const char *name);
+int analytics_append(const HistoryEntry *entry);
+int analytics_append_row(const HistoryRow *row);
+void analytics_load_history();
+int analytics_query(int kind, int32_t day_from, int32_t day_to, QueryResult *result);
+void free_query_result(QueryResult *result);
+void show_wardrobe_analytics();
+int run_analytics_benchmark(long long rows);
+
+// Wardrobe inventory
+int catalog_item_id(int kind, int category, int index);
+const char* catalog_item_name(int id);
+void init_catalog_sets();
+void init_wardrobe(Wardrobe *w);
+int32_t current_day();
+ItemSet wardrobe_candidates(Wardrobe *w, int category, int32_t today);
+int list_candidates(const ItemSet *candidates, int kind, int category, int out[]);
+void record_wear(Wardrobe *w, const int ids[], int count, int32_t today);
+void manage_wardrobe();
+
+// Event calendar
+int add_calendar_event(const SpecialEvent *info, int style, const char *start, const char *end);
+int load_event_calendar(const char *path);
+void init_event_calendar();
+int find_active_events(int32_t day, int out[], int max);
+
+// Group recommendations
+int recommend_group(const GroupMember members[], int count, const Weather *weather, int flags, GroupAssignment out[]);
+void plan_group_outfits(const Weather *weather);
+int run_group_benchmark(int count);
+
+// Hot-reloadable catalog
+void init_catalog();
+const Catalog* catalog_enter();
+void catalog_exit();
+const Catalog* current_catalog();
+int parse_catalog_file(const char *path, Catalog *out);
+int catalog_reload(const char *path);
+int catalog_watch_start(const char *path);
+void catalog_watch_stop();
+void report_catalog_updates();
+
+// Paginated views
+void browse_pages(const PagedView *view);
+int render_history_page(const PageCursor *at, const RecordFilter *filter, int page_size, int first_number, PageCursor *next);
+int render_rating_page(const PageCursor *at, const RecordFilter *filter, int page_size, int first_number, PageCursor *next);
+int render_favorite_page(const PageCursor *at, const RecordFilter *filter, int page_size, int first_number, PageCursor *next);
+float average_outfit_rating(const char *title);
+
+// Tiered history storage
+int cold_history_append(const HistoryEntry *entry);
+int cold_history_seal();
+int load_cold_segments();
+void history_row(const HistoryEntry *entry, HistoryRow *row);
+long long cold_history_scan(int64_t from, int64_t to, int (*visit)(const HistoryEntry *entry, void *user), void *user);
+long long cold_history_scan_rows(int64_t from, int64_t to, int (*visit)(const HistoryRow *row, void *user), void *user);
+long long cold_history_count(int64_t from, int64_t to);
+long long cold_history_rows();
+long long cold_history_bytes();
+int run_history_benchmark(long long rows);
+
+
+// =============================
+// USER NOTE FEATURE IMPLEMENTATION
+// =============================
+
+void get_user_note(char *note) {
+    printf("\n(Optional) Add a note about this outfit (e.g., occasion, mood, etc.): ");
+    fgets(note, MAX_LEN, stdin);
+    strip_newline(note);
+}
+
+// =============================
+// NEW FEATURE: MOOD INPUT IMPLEMENTATION
+// =============================
+
+void get_user_mood(char *mood) {
+    printf("\n(Optional) How are you feeling today? (e.g., happy, energetic, laid-back): ");
+    fgets(mood, MAX_LEN, stdin);
+    strip_newline(mood);
+}
+
+// =============================
+// CLOCK AND CALENDAR SERVICE
+// =============================
+// All date logic goes through build_date_context(), which only uses the
+// reentrant localtime_r()/gmtime_r() and caches the system timezone offset,
+// so a request (or a batch of records) pays for timezone work once.
+// Known cities use city_regions[]: a standard offset, a hemisphere and one
+// of the dst_rules[] (current EU, US, Australian, New Zealand and Chilean
+// rules; historical rule changes are not modelled). Other cities fall back
+// to the system timezone and northern seasons, and refresh_date_context()
+// says so.
+
+static time_t (*clock_source)(void) = NULL; // NULL means the system clock
+static time_t fixed_clock_value = 0;
+
+// Cached system timezone offset, valid for one UTC hour window (per thread,
+// so import workers can build date contexts concurrently)
+static THREAD_LOCAL time_t tz_cache_start = 0;
+static THREAD_LOCAL time_t tz_cache_end = 0;
+static THREAD_LOCAL long tz_cache_offset = 0;
+
+static time_t fixed_clock() {
+    return fixed_clock_value;
+}
+
+time_t clock_now() {
+    return clock_source ? clock_source() : time(NULL);
+}
+
+// Inject a clock (e.g. for deterministic benchmarks); NULL restores time()
+void set_clock_source(time_t (*source)(void)) {
+    clock_source = source;
+}
+
+void set_fixed_clock(time_t t) {
+    fixed_clock_value = t;
+    clock_source = fixed_clock;
+}
+
+
+const CityRegion* find_city_region(const char *city) {
+    if (!city || city[0] == '\0') return NULL;
+    for (int i = 0; i < NUM_CITY_REGIONS; i++) {
+        if (compare_names_ci(city, city_regions[i].city) == 0) return &city_regions[i];
+    }
+    return NULL;
+}
+
+// Seconds east of UTC for the system timezone at time t
+static long system_utc_offset(time_t t) {
+    if (t >= tz_cache_start && t < tz_cache_end) return tz_cache_offset;
+
+    struct tm local, utc;
+    localtime_r(&t, &local);
+    gmtime_r(&t, &utc);
+    long days = local.tm_yday - utc.tm_yday;
+    if (local.tm_year != utc.tm_year) days = local.tm_year > utc.tm_year ? 1 : -1;
+    tz_cache_offset = ((days * 24 + (local.tm_hour - utc.tm_hour)) * 60
+                       + (local.tm_min - utc.tm_min)) * 60 + (local.tm_sec - utc.tm_sec);
+
+    // DST changes happen on hour boundaries, so the offset holds for this UTC hour
+    tz_cache_start = t - (t % 3600);
+    tz_cache_end = tz_cache_start + 3600;
+    return tz_cache_offset;
+}
+
+int days_in_month(int year, int month) {
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return days[month - 1] + (month == 2 && leap);
+}
+
+// Day of the month of the first Sunday on or after day (-1 for the last Sunday)
+static int sunday_on_or_after(int year, int month, int day) {
+    if (day < 0) day = days_in_month(year, month) - 6;
+    int weekday = (int)((days_from_civil(year, month, day) % 7 + 11) % 7); // 0 = Sunday; 1970-01-01 was a Thursday
+    return day + (7 - weekday) % 7;
+}
+
+// UTC instant of a DST switch in the given year
+static time_t dst_switch(const CityRegion *region, int year, int month, int from_day, int hour, int utc) {
+    long long day = days_from_civil(year, month, sunday_on_or_after(year, month, from_day));
+    return (time_t)(day * 86400 + hour * 3600 - (utc ? 0 : region->utc_offset_min * 60L));
+}
+
+static int dst_in_effect(const CityRegion *region, time_t t) {
+    if (region->dst == DST_NONE) return 0;
+    const DstRule *r = &dst_rules[region->dst];
+    time_t standard = t + region->utc_offset_min * 60L;
+    struct tm local;
+    gmtime_r(&standard, &local);
+    int year = local.tm_year + 1900;
+    time_t start = dst_switch(region, year, r->start_month, r->start_day, r->start_hour, r->utc);
+    time_t end = dst_switch(region, year, r->end_month, r->end_day, r->end_hour, r->utc);
+    return start < end ? t >= start && t < end : t >= start || t < end;
+}
+
+// Fill ctx for time t in the given city (system timezone if the city is unknown)
+void build_date_context(time_t t, const char *city, DateContext *ctx) {
+    const CityRegion *region = find_city_region(city);
+    int dst = region && dst_in_effect(region, t);
+    time_t shifted = t + (region ? region->utc_offset_min * 60L + dst * 3600L : system_utc_offset(t));
+
+    ctx->now = t;
+    ctx->region = region;
+    gmtime_r(&shifted, &ctx->local);
+    ctx->local.tm_isdst = dst;
+    ctx->season = season_table[region ? region->hemisphere : HEMISPHERE_NORTH][ctx->local.tm_mon];
+}
+
+void refresh_date_context(const char *city) {
+    build_date_context(clock_now(), city, &date_ctx);
+    if (city && city[0] && !date_ctx.region)
+        printf(YELLOW "\n%s is not in the city table: using this computer's timezone and northern-hemisphere seasons.\n" RESET, city);
+}
+
+// =============================
+// BULK WEATHER IMPORT
+// =============================
+// CSV rows are "city,timestamp,temperature,condition" where the timestamp is
+// either Unix seconds or "YYYY-MM-DD HH:MM[:SS]" (UTC). The file is mapped
+// read-only, cut into one chunk per core on line boundaries, and each worker
+// parses its chunk in place: fields are located with memchr() and a
+// word-at-a-time comma scan, and copied straight into a stack Weather record.
+
+typedef struct {
+    const char *begin;
+    const char *end;
+    int worker;
+    WeatherSink sink;
+    void *user;
+    long long records;
+    long long rejected;
+} ImportChunk;
+
+int get_category_index(float temp) {
+    if (temp < 15.0) return 0;
+    else if (temp <= 30.0) return 1;
+    return 2;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (month 1-12)
+long long days_from_civil(int year, int month, int day) {
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yoe = (unsigned)(year - era * 400);
+    unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (long long)doe - 719468;
+}
+
+double monotonic_seconds() {
+#ifdef _WIN32
+    return (double)clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+// Next ',' in [p, end), or end. Checks eight bytes per step (SWAR).
+static const char *find_comma(const char *p, const char *end) {
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    const uint64_t commas = ones * ',';
+    while (end - p >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        uint64_t x = word ^ commas;
+        uint64_t hit = (x - ones) & ~x & highs;
+        if (hit) return p + (__builtin_ctzll(hit) >> 3);
+        p += 8;
+    }
+#endif
+    while (p < end && *p != ',') p++;
+    return p;
+}
+
+static int parse_digits(const char *p, int n, int *out) {
+    int v = 0;
+    for (int i = 0; i < n; i++) {
+        if (p[i] < '0' || p[i] > '9') return 0;
+        v = v * 10 + (p[i] - '0');
+    }
+    *out = v;
+    return 1;
+}
+
+// Unix seconds, or exactly YYYY-MM-DD HH:MM[:SS] filling the whole field
+static int parse_timestamp_field(const char *p, const char *end, time_t *out) {
+    long len = end - p;
+    if (len >= 16 && p[4] == '-' && p[7] == '-' && (p[10] == ' ' || p[10] == 'T') && p[13] == ':') {
+        int y, mo, d, h, mi, sec = 0;
+        if (len != 16 && !(len == 19 && p[16] == ':')) return 0;
+        if (!parse_digits(p, 4, &y) || !parse_digits(p + 5, 2, &mo) || !parse_digits(p + 8, 2, &d) ||
+            !parse_digits(p + 11, 2, &h) || !parse_digits(p + 14, 2, &mi))
+            return 0;
+        if (len == 19 && !parse_digits(p + 17, 2, &sec)) return 0;
+        if (mo < 1 || mo > 12 || d < 1 || d > days_in_month(y, mo) || h > 23 || mi > 59 || sec > 60) return 0;
+        *out = (time_t)(days_from_civil(y, mo, d) * 86400 + h * 3600 + mi * 60 + sec);
+        return 1;
+    }
+
+    long long v = 0;
+    if (len == 0 || len > 18) return 0;
+    for (const char *q = p; q < end; q++) {
+        if (*q < '0' || *q > '9') return 0;
+        v = v * 10 + (*q - '0');
+    }
+    *out = (time_t)v;
+    return 1;
+}
+
+static int parse_temp_field(const char *p, const char *end, float *out) {
+    int negative = 0, digits = 0;
+    float value = 0.0f, scale = 1.0f;
+    while (p < end && *p == ' ') p++;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+    for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) value = value * 10.0f + (*p - '0');
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+            scale *= 0.1f;
+            value += (*p - '0') * scale;
+        }
+    }
+    while (p < end && *p == ' ') p++;
+    if (digits == 0 || p != end) return 0;
+    *out = negative ? -value : value;
+    return *out >= MIN_TEMP && *out <= MAX_TEMP;
+}
+
+static void copy_field(char *dst, const char *p, const char *end) {
+    size_t len = (size_t)(end - p);
+    if (len > MAX_LEN - 1) len = MAX_LEN - 1;
+    memcpy(dst, p, len);
+    dst[len] = '\0';
+}
+
+static void *import_chunk_worker(void *arg) {
+    ImportChunk *chunk = arg;
+    const char *p = chunk->begin;
+    Weather w;
+
+    while (p < chunk->end) {
+        const char *eol = memchr(p, '\n', (size_t)(chunk->end - p));
+        if (!eol) eol = chunk->end;
+        const char *line_end = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+
+        const char *c1 = find_comma(p, line_end);
+        const char *c2 = c1 < line_end ? find_comma(c1 + 1, line_end) : line_end;
+        const char *c3 = c2 < line_end ? find_comma(c2 + 1, line_end) : line_end;
+        time_t ts;
+
+        if (line_end == p) {
+            // Blank line
+        } else if (c3 < line_end && c1 > p &&
+                   parse_timestamp_field(c1 + 1, c2, &ts) &&
+                   parse_temp_field(c2 + 1, c3, &w.temp)) {
+            copy_field(w.city, p, c1);
+            copy_field(w.condition, c3 + 1, line_end);
+            chunk->sink(&w, ts, chunk->worker, chunk->user);
+            chunk->records++;
+        } else {
+            chunk->rejected++;
+        }
+        p = eol + 1;
+    }
+    return NULL;
+}
+
+// Parse a whole CSV export, calling sink for every valid row.
+// sink runs concurrently on up to MAX_IMPORT_THREADS workers. Returns 0 on success.
+int import_weather_csv(const char *path, WeatherSink sink, void *user, ImportStats *stats) {
+    double start = monotonic_seconds();
+    const char *data;
+    size_t size;
+
+#ifdef _WIN32
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        printf(RED "Could not open %s\n" RESET, path);
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *buffer = malloc(size ? size : 1);
+    if (!buffer || fread(buffer, 1, size, fp) != size) {
+        printf(RED "Could not read %s\n" RESET, path);
+        free(buffer);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    data = buffer;
+    int workers = 1;
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        printf(RED "Could not open %s\n" RESET, path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    size = (size_t)st.st_size;
+    void *map = size ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf(RED "Could not map %s\n" RESET, path);
+        return -1;
+    }
+    if (size) madvise(map, size, MADV_SEQUENTIAL);
+    data = map;
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int workers = cores < 1 ? 1 : (cores > MAX_IMPORT_THREADS ? MAX_IMPORT_THREADS : (int)cores);
+    if (size < (size_t)workers * 65536) workers = 1; // Not worth the threads
+#endif
+
+    const char *begin = data;
+    const char *end = data + size;
+
+    // Skip the header row; any other first line is parsed as a record
+    static const char header[] = "city,timestamp,temperature,condition";
+    size_t header_len = sizeof(header) - 1;
+    if (size >= header_len && memcmp(begin, header, header_len) == 0) {
+        const char *rest = begin + header_len;
+        if (rest < end && *rest == '\r') rest++;
+        if (rest == end || *rest == '\n') begin = rest < end ? rest + 1 : end;
+    }
+
+    ImportChunk chunks[MAX_IMPORT_THREADS];
+    size_t span = (size_t)(end - begin) / workers;
+    const char *cursor = begin;
+    for (int i = 0; i < workers; i++) {
+        // Nominal boundary, clamped: an earlier chunk may already have run past it on a long line
+        const char *stop = (i == workers - 1) ? end : begin + (size_t)(i + 1) * span;
+        if (stop < cursor) stop = cursor;
+        if (stop > end) stop = end;
+        if (stop < end) {
+            const char *eol = memchr(stop, '\n', (size_t)(end - stop));
+            stop = eol ? eol + 1 : end;
+        }
+        chunks[i] = (ImportChunk){cursor, stop, i, sink, user, 0, 0};
+        cursor = stop;
+    }
+
+#ifdef _WIN32
+    import_chunk_worker(&chunks[0]);
+#else
+    pthread_t threads[MAX_IMPORT_THREADS];
+    int started[MAX_IMPORT_THREADS] = {0};
+    for (int i = 1; i < workers; i++) {
+        started[i] = pthread_create(&threads[i], NULL, import_chunk_worker, &chunks[i]) == 0;
+        if (!started[i]) import_chunk_worker(&chunks[i]); // Fall back to parsing it here
+    }
+    import_chunk_worker(&chunks[0]);
+    for (int i = 1; i < workers; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+#endif
+
+    ImportStats result = {0, 0, (long long)size, workers, 0.0};
+    for (int i = 0; i < workers; i++) {
+        result.records += chunks[i].records;
+        result.rejected += chunks[i].rejected;
+    }
+    result.seconds = monotonic_seconds() - start;
+    if (stats) *stats = result;
+
+#ifdef _WIN32
+    free(buffer);
+#else
+    if (size) munmap(map, size);
+#endif
+    return 0;
+}
+
+// Per-worker tally, padded to a cache line so workers never share one
+typedef struct {
+    long long counts[NUM_CATEGORIES];
+    char pad[64 - NUM_CATEGORIES * sizeof(long long)];
+} CategoryTally;
+
+static void tally_category_sink(const Weather *weather, time_t timestamp, int worker, void *user) {
+    CategoryTally *tallies = user;
+    (void)timestamp;
+    tallies[worker].counts[get_category_index(weather->temp)]++;
+}
+
+// Command-line entry point: import a CSV and summarize it by outfit category
+int run_bulk_import(const char *path) {
+    static CategoryTally tallies[MAX_IMPORT_THREADS];
+    ImportStats stats;
+
+    memset(tallies, 0, sizeof(tallies));
+    if (import_weather_csv(path, tally_category_sink, tallies, &stats) != 0) return -1;
+
+    printf(CYAN "\n--- Bulk Import Summary ---\n" RESET);
+    printf("Records: %lld (rejected: %lld)\n", stats.records, stats.rejected);
+    printf("Parsed %.1f MB in %.3f s on %d thread(s) (%.1f MB/s)\n", stats.bytes / 1e6, stats.seconds,
+           stats.workers, stats.seconds > 0 ? stats.bytes / 1e6 / stats.seconds : 0.0);
+    for (int c = 0; c < NUM_CATEGORIES; c++) {
+        long long total = 0;
+        for (int i = 0; i < stats.workers; i++) total += tallies[i].counts[c];
+        printf("%s-weather observations: %lld\n", categories[c], total);
+    }
+    return 0;
+}
+
+// =============================
+// CLIMATOLOGY TABLE
+// =============================
+// Imported observations are folded into a per-city x month x hour table of
+// temperature ranges and dominant conditions, with the best outfit for each
+// cell picked at build time. The table is written as one flat file and
+// mapped at startup, so a default recommendation is a single cell lookup.
+
+typedef struct {
+    double temp_sum;
+    float temp_min;
+    float temp_max;
+    uint32_t samples;
+    uint32_t condition_counts[NUM_CONDITIONS];
+} ClimateAccum;
+
+typedef struct {
+    char name[CLIMATE_CITY_LEN];
+    ClimateAccum *cells; // CLIMATE_CELLS_PER_CITY entries, allocated on first sighting
+} ClimateCityAccum;
+
+// Private to one import worker, so the hot path takes no locks
+typedef struct {
+    ClimateCityAccum cities[MAX_CLIMATE_CITIES];
+    int slots[CLIMATE_HASH_SLOTS]; // City index + 1, 0 when empty
+    int city_count;
+    long long dropped;             // Rows for cities beyond MAX_CLIMATE_CITIES
+} ClimateWorker;
+
+int get_condition_index(const char *condition) {
+    if (strstr(condition, "Sun") || strstr(condition, "sun") || strstr(condition, "Clear") || strstr(condition, "clear"))
+        return 0;
+    if (strstr(condition, "Rain") || strstr(condition, "rain") || strstr(condition, "Drizzle") || strstr(condition, "drizzle"))
+        return 1;
+    if (strstr(condition, "Cloud") || strstr(condition, "cloud") || strstr(condition, "Overcast") || strstr(condition, "overcast"))
+        return 2;
+    if (strstr(condition, "Snow") || strstr(condition, "snow"))
+        return 3;
+    if (strstr(condition, "Wind") || strstr(condition, "wind"))
+        return 4;
+    return 5;
+}
+
+static unsigned city_hash(const char *city) {
+    unsigned h = 2166136261u; // FNV-1a over the lower-cased name
+    for (; *city; city++) h = (h ^ (unsigned char)tolower((unsigned char)*city)) * 16777619u;
+    return h;
+}
+
+// City names are keyed by their first CLIMATE_CITY_LEN - 1 characters,
+// the part that fits in the table, both when building and when looking up
+static void climate_city_key(char key[CLIMATE_CITY_LEN], const char *city) {
+    strncpy(key, city, CLIMATE_CITY_LEN - 1);
+    key[CLIMATE_CITY_LEN - 1] = '\0';
+}
+
+// Accumulators for a city in this worker; adds the city if create is set
+static ClimateAccum *climate_worker_city(ClimateWorker *w, const char *name, int create) {
+    char city[CLIMATE_CITY_LEN];
+    climate_city_key(city, name);
+    unsigned slot = city_hash(city) % CLIMATE_HASH_SLOTS;
+    for (int probe = 0; probe < CLIMATE_HASH_SLOTS; probe++, slot = (slot + 1) % CLIMATE_HASH_SLOTS) {
+        int idx = w->slots[slot] - 1;
+        if (idx < 0) break;
+        if (compare_names_ci(w->cities[idx].name, city) == 0) return w->cities[idx].cells;
+    }
+    if (!create || w->city_count >= MAX_CLIMATE_CITIES || w->slots[slot] != 0) return NULL;
+
+    ClimateCityAccum *c = &w->cities[w->city_count];
+    c->cells = calloc(CLIMATE_CELLS_PER_CITY, sizeof(ClimateAccum));
+    if (!c->cells) return NULL;
+    memcpy(c->name, city, CLIMATE_CITY_LEN);
+    w->slots[slot] = ++w->city_count;
+    return c->cells;
+}
+
+static void climate_sink(const Weather *weather, time_t timestamp, int worker, void *user) {
+    ClimateWorker *w = &((ClimateWorker *)user)[worker];
+    ClimateAccum *cells = climate_worker_city(w, weather->city, 1);
+    if (!cells) {
+        w->dropped++;
+        return;
+    }
+
+    DateContext ctx;
+    build_date_context(timestamp, weather->city, &ctx);
+    ClimateAccum *a = &cells[ctx.local.tm_mon * 24 + ctx.local.tm_hour];
+    if (a->samples == 0 || weather->temp < a->temp_min) a->temp_min = weather->temp;
+    if (a->samples == 0 || weather->temp > a->temp_max) a->temp_max = weather->temp;
+    a->temp_sum += weather->temp;
+    a->samples++;
+    a->condition_counts[get_condition_index(weather->condition)]++;
+}
+
+static int compare_climate_cities(const void *a, const void *b) {
+    return compare_names_ci(((const ClimateCity *)a)->name, ((const ClimateCity *)b)->name);
+}
+
+// Best-rated outfit in a category, or -1 when no rating mentions one
+static int best_rated_outfit(const Outfit outfits[]) {
+    int best = -1;
+    float best_avg = 0.0f;
+    for (int i = 0; i < NUM_OUTFITS; i++) {
+        int sum = 0, n = 0;
+        for (int r = 0; r < rating_count; r++) {
+            if (strcmp(ratings[r].outfit_name, outfits[i].title) == 0) {
+                sum += ratings[r].rating;
+                n++;
+            }
+        }
+        if (n > 0 && (float)sum / n > best_avg) {
+            best_avg = (float)sum / n;
+            best = i;
+        }
+    }
+    return best;
+}
+
+static void finish_climate_cell(const ClimateAccum *a, ClimateCell *cell, const int best_outfit[]) {
+    memset(cell, 0, sizeof(*cell));
+    if (a->samples == 0) return;
+
+    int dominant = 0;
+    for (int c = 1; c < NUM_CONDITIONS; c++) {
+        if (a->condition_counts[c] > a->condition_counts[dominant]) dominant = c;
+    }
+    cell->valid = 1;
+    cell->samples = a->samples;
+    cell->temp_min = a->temp_min;
+    cell->temp_max = a->temp_max;
+    cell->temp_mean = (float)(a->temp_sum / a->samples);
+    cell->condition = (uint8_t)dominant;
+    cell->category = (uint8_t)get_category_index(cell->temp_mean);
+
+    const unsigned char *pick = condition_picks[cell->category][dominant];
+    cell->outfit = best_outfit[cell->category] >= 0 ? (uint8_t)best_outfit[cell->category] : pick[0];
+    cell->accessory = pick[1];
+    cell->shoe = pick[2];
+    cell->jacket = pick[3];
+}
+
+// Fill empty hours from the nearest observed hour of the same month
+static void fill_climate_gaps(ClimateCell *month_cells) {
+    ClimateCell source[24];
+    memcpy(source, month_cells, sizeof(source));
+    for (int h = 0; h < 24; h++) {
+        if (source[h].valid) continue;
+        for (int d = 1; d <= 12; d++) {
+            int before = (h - d + 24) % 24, after = (h + d) % 24;
+            int from = source[before].valid ? before : (source[after].valid ? after : -1);
+            if (from >= 0) {
+                month_cells[h] = source[from];
+                month_cells[h].samples = 0;
+                break;
+            }
+        }
+    }
+}
+
+// Build the climatology file from a CSV export (see import_weather_csv())
+int build_climate_table(const char *csv_path, const char *out_path) {
+    ClimateWorker *workers = calloc(MAX_IMPORT_THREADS, sizeof(ClimateWorker));
+    if (!workers) return -1;
+
+    ImportStats stats;
+    int status = import_weather_csv(csv_path, climate_sink, workers, &stats);
+
+    // Merge the per-worker city lists into one sorted directory
+    ClimateCity *cities = calloc(MAX_CLIMATE_CITIES, sizeof(ClimateCity));
+    int city_count = 0;
+    long long dropped = 0;
+    for (int w = 0; status == 0 && cities && w < stats.workers; w++) {
+        dropped += workers[w].dropped;
+        for (int i = 0; i < workers[w].city_count; i++) {
+            int known = 0;
+            for (int j = 0; j < city_count && !known; j++)
+                known = compare_names_ci(cities[j].name, workers[w].cities[i].name) == 0;
+            if (!known && city_count < MAX_CLIMATE_CITIES)
+                memcpy(cities[city_count++].name, workers[w].cities[i].name, CLIMATE_CITY_LEN);
+        }
+    }
+    if (cities) qsort(cities, city_count, sizeof(ClimateCity), compare_climate_cities);
+
+    size_t cells_offset = sizeof(ClimateHeader) + (size_t)city_count * sizeof(ClimateCity);
+    size_t file_size = cells_offset + (size_t)city_count * CLIMATE_CELLS_PER_CITY * sizeof(ClimateCell);
+    char *image = (status == 0 && cities) ? calloc(1, file_size) : NULL;
+    if (!image) status = -1;
+
+    if (status == 0) {
+        ClimateHeader *header = (ClimateHeader *)image;
+        memcpy(header->magic, "CLIMATE", 8);
+        header->version = CLIMATE_VERSION;
+        header->city_count = (uint32_t)city_count;
+        header->cells_offset = (uint32_t)cells_offset;
+        header->file_size = (uint32_t)file_size;
+        memcpy(image + sizeof(ClimateHeader), cities, (size_t)city_count * sizeof(ClimateCity));
+
+        const Catalog *catalog = catalog_enter();
+        int best_outfit[NUM_CATEGORIES] = {
+            best_rated_outfit(catalog->outfits[0]), best_rated_outfit(catalog->outfits[1]), best_rated_outfit(catalog->outfits[2])
+        };
+        catalog_exit();
+        ClimateCell *out = (ClimateCell *)(image + cells_offset);
+        ClimateAccum merged[CLIMATE_CELLS_PER_CITY];
+
+        for (int c = 0; c < city_count; c++) {
+            memset(merged, 0, sizeof(merged));
+            for (int w = 0; w < stats.workers; w++) {
+                ClimateAccum *src = climate_worker_city(&workers[w], cities[c].name, 0);
+                for (int k = 0; src && k < CLIMATE_CELLS_PER_CITY; k++) {
+                    ClimateAccum *a = &merged[k], *b = &src[k];
+                    if (b->samples == 0) continue;
+                    if (a->samples == 0 || b->temp_min < a->temp_min) a->temp_min = b->temp_min;
+                    if (a->samples == 0 || b->temp_max > a->temp_max) a->temp_max = b->temp_max;
+                    a->temp_sum += b->temp_sum;
+                    a->samples += b->samples;
+                    for (int k2 = 0; k2 < NUM_CONDITIONS; k2++) a->condition_counts[k2] += b->condition_counts[k2];
+                }
+            }
+            ClimateCell *city_cells = &out[(size_t)c * CLIMATE_CELLS_PER_CITY];
+            for (int k = 0; k < CLIMATE_CELLS_PER_CITY; k++) finish_climate_cell(&merged[k], &city_cells[k], best_outfit);
+            for (int m = 0; m < 12; m++) fill_climate_gaps(&city_cells[m * 24]);
+        }
+
+        // Write to a temporary file and rename, so readers never see a partial table
+        char tmp_path[MAX_LEN + 8];
+        snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", out_path);
+        FILE *fp = fopen(tmp_path, "wb");
+        if (!fp || fwrite(image, 1, file_size, fp) != file_size || fclose(fp) != 0) {
+            printf(RED "Could not write %s\n" RESET, tmp_path);
+            status = -1;
+        } else if (rename(tmp_path, out_path) != 0) {
+            printf(RED "Could not replace %s\n" RESET, out_path);
+            status = -1;
+        }
+    }
+
+    if (status == 0) {
+        printf(GREEN "\nClimatology built: %d cities from %lld observations (%lld rejected, %lld over the city limit) in %.3f s\n" RESET,
+               city_count, stats.records, stats.rejected, dropped, stats.seconds);
+    }
+
+    for (int w = 0; w < MAX_IMPORT_THREADS; w++) {
+        for (int i = 0; i < workers[w].city_count; i++) free(workers[w].cities[i].cells);
+    }
+    free(workers);
+    free(cities);
+    free(image);
+    return status;
+}
+
+// Map the climatology file; returns 0 if a valid table is now loaded
+int load_climate_table(const char *path) {
+    void *data = NULL;
+    size_t size = 0;
+
+#ifdef _WIN32
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return -1;
+    fseek(fp, 0, SEEK_END);
+    size = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    data = malloc(size ? size : 1);
+    if (!data || fread(data, 1, size, fp) != size) {
+        free(data);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        size = (size_t)st.st_size;
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) data = NULL;
+    }
+    close(fd);
+    if (!data) return -1;
+#endif
+
+    const ClimateHeader *h = data;
+    int ok = size >= sizeof(ClimateHeader) && memcmp(h->magic, "CLIMATE", 8) == 0 &&
+             h->version == CLIMATE_VERSION && h->file_size == size && h->city_count <= MAX_CLIMATE_CITIES &&
+             h->cells_offset == sizeof(ClimateHeader) + h->city_count * sizeof(ClimateCity) &&
+             size == h->cells_offset + (size_t)h->city_count * CLIMATE_CELLS_PER_CITY * sizeof(ClimateCell);
+    if (!ok) {
+        printf(RED "Ignoring invalid climatology file %s\n" RESET, path);
+#ifdef _WIN32
+        free(data);
+#else
+        munmap(data, size);
+#endif
+        return -1;
+    }
+
+    climate.header = h;
+    climate.cities = (const ClimateCity *)((const char *)data + sizeof(ClimateHeader));
+    climate.cells = (const ClimateCell *)((const char *)data + h->cells_offset);
+    climate.data = data;
+    climate.size = size;
+    return 0;
+}
+
+// Expected weather and outfit for a city at time t, or NULL if unknown
+const ClimateCell* lookup_climate(const char *name, time_t t) {
+    if (!climate.header || !name || name[0] == '\0') return NULL;
+    char city[CLIMATE_CITY_LEN];
+    climate_city_key(city, name);
+
+    int lo = 0, hi = (int)climate.header->city_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = compare_names_ci(city, climate.cities[mid].name);
+        if (cmp == 0) {
+            DateContext ctx;
+            build_date_context(t, name, &ctx);
+            const ClimateCell *cell =
+                &climate.cells[(size_t)mid * CLIMATE_CELLS_PER_CITY + ctx.local.tm_mon * 24 + ctx.local.tm_hour];
+            return cell->valid ? cell : NULL;
+        }
+        if (cmp < 0) hi = mid - 1;
+        else lo = mid + 1;
+    }
+    return NULL;
+}
+
+void show_climate_default(const char *city) {
+    const ClimateCell *cell = lookup_climate(city, clock_now());
+    if (!cell) {
+        printf(YELLOW "\nNo climatology available for %s.\n" RESET, city);
+        return;
+    }
+
+    const Catalog *catalog = catalog_enter();
+    const Outfit *o = &catalog->outfits[cell->category][cell->outfit];
+
+    printf(CYAN "\n--- Typical Weather for %s Right Now ---\n" RESET, city);
+    printf("Expected: %.1f°C to %.1f°C (avg %.1f°C), mostly %s\n",
+           cell->temp_min, cell->temp_max, cell->temp_mean, conditions[cell->condition]);
+    printf(GREEN "Default outfit: %s\n" RESET, o->title);
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        printf("- %s\n", o->items[i]);
+    }
+    printf("Accessory: %s\n", catalog->accessories[cell->category][cell->accessory]);
+    printf("Shoes: %s\n", catalog->shoes[cell->category][cell->shoe]);
+    printf("Jacket: %s\n", catalog->jackets[cell->category][cell->jacket]);
+    catalog_exit();
+}
+
+// =============================
+// ASYNCHRONOUS EVENT LOG
+// =============================
+// Producers copy events into a bounded lock-free ring (per-slot sequence
+// numbers, so any thread may push) and return immediately; if the ring is
+// full the event is counted as dropped rather than waiting. A single writer
+// thread drains it in batches into length-prefixed records, rotating to a
+// new segment file every EVENT_SEGMENT_BYTES. Events that cannot be written
+// (no segment, failed write) or arrive after event_log_stop() are dropped too.
+//
+// Segment layout: "EVTLOG1\n", then per record
+//   u32 length | u8 type | i32 value | i64 timestamp | u16 n | subject | u16 n | text
+
+typedef struct {
+    atomic_size_t sequence;
+    Event event;
+} EventSlot;
+
+static EventSlot event_ring[EVENT_RING_SIZE];
+static atomic_size_t event_enqueue_pos;
+static atomic_size_t event_dequeue_pos;   // Advanced only by the writer
+static atomic_int event_log_running;      // Writer thread keeps draining
+static atomic_int event_log_accepting;    // log_event() may push
+static atomic_int event_producers;        // log_event() calls in flight
+static atomic_llong event_logged, event_written, event_dropped, event_backpressure, event_bytes;
+static FILE *event_segment = NULL;
+static long event_segment_size = 0;
+static int event_segment_number = 0;
+static char event_prefix[MAX_LEN] = EVENT_LOG_PREFIX;
+#ifndef _WIN32
+static pthread_t event_writer;
+#endif
+
+static int open_event_segment() {
+    char path[MAX_LEN + 32];
+    if (event_segment) fclose(event_segment);
+    event_segment = NULL;
+
+    // Continue after the newest existing segment
+    for (event_segment_number++;; event_segment_number++) {
+        snprintf(path, sizeof(path), "%s-%06d.log", event_prefix, event_segment_number);
+        FILE *existing = fopen(path, "rb");
+        if (!existing) break;
+        fclose(existing);
+    }
+    event_segment = fopen(path, "wb");
+    if (!event_segment) return -1;
+    fwrite("EVTLOG1\n", 1, 8, event_segment);
+    event_segment_size = 8;
+    return 0;
+}
+
+static size_t encode_event(const Event *e, unsigned char *out) {
+    uint16_t subject_len = (uint16_t)strnlen(e->subject, MAX_LEN - 1);
+    uint16_t text_len = (uint16_t)strnlen(e->text, EVENT_TEXT_LEN - 1);
+    uint32_t length = 1 + 4 + 8 + 2 + subject_len + 2 + text_len;
+    unsigned char *p = out;
+    uint8_t type = (uint8_t)e->type;
+    int32_t value = e->value;
+
+    memcpy(p, &length, 4); p += 4;
+    memcpy(p, &type, 1); p += 1;
+    memcpy(p, &value, 4); p += 4;
+    memcpy(p, &e->timestamp, 8); p += 8;
+    memcpy(p, &subject_len, 2); p += 2;
+    memcpy(p, e->subject, subject_len); p += subject_len;
+    memcpy(p, &text_len, 2); p += 2;
+    memcpy(p, e->text, text_len); p += text_len;
+    return (size_t)(p - out);
+}
+
+// Drain up to one batch from the ring into the current segment; returns events written
+static int drain_event_batch() {
+    static unsigned char buffer[EVENT_BATCH_SIZE * (sizeof(Event) + 16)];
+    size_t used = 0;
+    int n = 0;
+
+    size_t pos = atomic_load_explicit(&event_dequeue_pos, memory_order_relaxed);
+
+    while (n < EVENT_BATCH_SIZE) {
+        EventSlot *slot = &event_ring[pos & (EVENT_RING_SIZE - 1)];
+        size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (seq != pos + 1) break; // Nothing published here yet
+        used += encode_event(&slot->event, buffer + used);
+        atomic_store_explicit(&slot->sequence, pos + EVENT_RING_SIZE, memory_order_release);
+        pos++;
+        n++;
+    }
+    atomic_store_explicit(&event_dequeue_pos, pos, memory_order_relaxed);
+    if (n == 0) return 0;
+
+    if (!event_segment || event_segment_size + (long)used > EVENT_SEGMENT_BYTES) open_event_segment();
+    if (event_segment && fwrite(buffer, 1, used, event_segment) == used && fflush(event_segment) == 0) {
+        event_segment_size += (long)used;
+        atomic_fetch_add(&event_written, n);
+        atomic_fetch_add(&event_bytes, (long long)used);
+    } else {
+        atomic_fetch_add(&event_dropped, n); // Already taken off the ring; nowhere to put them
+    }
+    return n;
+}
+
+#ifndef _WIN32
+static void *event_writer_main(void *arg) {
+    (void)arg;
+    while (atomic_load(&event_log_running)) {
+        if (drain_event_batch() == 0) {
+            struct timespec pause = {0, 2000000}; // 2 ms when idle
+            nanosleep(&pause, NULL);
+        }
+    }
+    while (drain_event_batch() > 0); // Flush whatever is left
+    return NULL;
+}
+#endif
+
+int event_log_start(const char *prefix) {
+    if (atomic_load(&event_log_running)) return 0;
+    for (size_t i = 0; i < EVENT_RING_SIZE; i++) atomic_init(&event_ring[i].sequence, i);
+    atomic_store(&event_enqueue_pos, 0);
+    atomic_store(&event_dequeue_pos, 0);
+    if (prefix) {
+        strncpy(event_prefix, prefix, MAX_LEN - 1);
+        event_prefix[MAX_LEN - 1] = '\0';
+    }
+
+    atomic_store(&event_log_running, 1);
+#ifndef _WIN32
+    if (pthread_create(&event_writer, NULL, event_writer_main, NULL) != 0) {
+        atomic_store(&event_log_running, 0);
+        return -1;
+    }
+#endif
+    atomic_store(&event_log_accepting, 1);
+    return 0;
+}
+
+// Refuse new events, wait for pushes already in flight, then let the writer drain the ring
+void event_log_stop() {
+    if (!atomic_exchange(&event_log_accepting, 0)) return;
+#ifndef _WIN32
+    while (atomic_load(&event_producers) > 0) {
+        struct timespec pause = {0, 100000};
+        nanosleep(&pause, NULL);
+    }
+#endif
+    atomic_store(&event_log_running, 0);
+#ifndef _WIN32
+    pthread_join(event_writer, NULL);
+#else
+    while (drain_event_batch() > 0);
+#endif
+    if (event_segment) fclose(event_segment);
+    event_segment = NULL;
+}
+
+// Queue an event without blocking; returns 0 if it was dropped
+int log_event(int type, int value, const char *subject, const char *text) {
+    // Announce the push before checking the flag so event_log_stop() cannot miss it
+    atomic_fetch_add(&event_producers, 1);
+    if (!atomic_load(&event_log_accepting)) {
+        atomic_fetch_sub(&event_producers, 1);
+        atomic_fetch_add_explicit(&event_dropped, 1, memory_order_relaxed); // Log stopped
+        return 0;
+    }
+
+    size_t pos = atomic_load_explicit(&event_enqueue_pos, memory_order_relaxed);
+    EventSlot *slot;
+    for (;;) {
+        slot = &event_ring[pos & (EVENT_RING_SIZE - 1)];
+        size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&event_enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&event_dropped, 1, memory_order_relaxed); // Ring full
+            atomic_fetch_sub(&event_producers, 1);
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&event_enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    Event *e = &slot->event;
+    e->type = type;
+    e->value = value;
+    e->timestamp = (int64_t)clock_now();
+    snprintf(e->subject, sizeof(e->subject), "%s", subject ? subject : "");
+    snprintf(e->text, sizeof(e->text), "%s", text ? text : "");
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+
+    atomic_fetch_add_explicit(&event_logged, 1, memory_order_relaxed);
+    if (pos - atomic_load_explicit(&event_dequeue_pos, memory_order_relaxed) > EVENT_RING_SIZE * 3 / 4)
+        atomic_fetch_add_explicit(&event_backpressure, 1, memory_order_relaxed);
+#ifdef _WIN32
+    drain_event_batch(); // No writer thread; persist inline
+#endif
+    atomic_fetch_sub(&event_producers, 1);
+    return 1;
+}
+
+EventLogStats event_log_stats() {
+    EventLogStats st;
+    st.logged = atomic_load(&event_logged);
+    st.written = atomic_load(&event_written);
+    st.dropped = atomic_load(&event_dropped);
+    st.backpressure = atomic_load(&event_backpressure);
+    st.bytes = atomic_load(&event_bytes);
+    st.segment = event_segment_number;
+    return st;
+}
+
+#ifndef _WIN32
+static void *event_bench_producer(void *arg) {
+    long long n = *(long long *)arg;
+    for (long long i = 0; i < n; i++) {
+        log_event(EVENT_RATING, (int)(i % 5) + 1, "Benchmark Outfit", "synthetic event");
+    }
+    return NULL;
+}
+#endif
+
+// Benchmarks write into a fresh directory so they never touch the real logs
+int make_scratch_dir(char *dir, size_t size) {
+#ifdef _WIN32
+    snprintf(dir, size, "bench-%lu", (unsigned long)GetCurrentProcessId());
+    return CreateDirectoryA(dir, NULL) ? 0 : -1;
+#else
+    const char *base = getenv("TMPDIR");
+    snprintf(dir, size, "%s/outfit-bench-XXXXXX", base && base[0] ? base : "/tmp");
+    return mkdtemp(dir) ? 0 : -1;
+#endif
+}
+
+// Remove a scratch directory once the caller has deleted its files
+void remove_scratch_dir(const char *dir) {
+#ifdef _WIN32
+    RemoveDirectoryA(dir);
+#else
+    rmdir(dir);
+#endif
+}
+
+// Command-line throughput check: push count events from four producer threads.
+// The rate reported is events actually written; dropped pushes are listed separately.
+int run_event_benchmark(long long count) {
+    char dir[MAX_LEN / 2], prefix[MAX_LEN];
+    if (make_scratch_dir(dir, sizeof(dir)) != 0) {
+        printf(RED "Could not create a scratch directory for the benchmark\n" RESET);
+        return -1;
+    }
+    snprintf(prefix, sizeof(prefix), "%s/%s", dir, EVENT_LOG_PREFIX);
+    if (event_log_start(prefix) != 0) {
+        remove_scratch_dir(dir);
+        return -1;
+    }
+    double start = monotonic_seconds();
+#ifndef _WIN32
+    pthread_t producers[4];
+    long long per_thread = count / 4;
+    for (int i = 0; i < 4; i++) pthread_create(&producers[i], NULL, event_bench_producer, &per_thread);
+    for (int i = 0; i < 4; i++) pthread_join(producers[i], NULL);
+#else
+    for (long long i = 0; i < count; i++) log_event(EVENT_RATING, (int)(i % 5) + 1, "Benchmark Outfit", "synthetic event");
+#endif
+    double pushed = monotonic_seconds() - start;
+    event_log_stop();
+    double total = monotonic_seconds() - start;
+
+    EventLogStats st = event_log_stats();
+    printf(CYAN "\n--- Event Log Benchmark ---\n" RESET);
+    printf("Written: %lld events in %.3f s (%.0f events/s, %.1f MB)\n",
+           st.written, total, total > 0 ? st.written / total : 0.0, st.bytes / 1e6);
+    printf("Producers finished in %.3f s; dropped: %lld of %lld, backpressure: %lld\n",
+           pushed, st.dropped, st.written + st.dropped, st.backpressure);
+
+    char path[MAX_LEN + 32];
+    for (int i = 1; i <= st.segment; i++) {
+        snprintf(path, sizeof(path), "%s-%06d.log", prefix, i);
+        remove(path);
+    }
+    remove_scratch_dir(dir);
+    return 0;
+}
+
+// =============================
+// STATE SNAPSHOTS
+// =============================
+// History, ratings, favorites and the catalog are saved as one image: a
+// checksummed header followed by page-aligned sections of the raw structs
+// (which hold no pointers). Startup maps the file copy-on-write, checks
+// every section checksum and points the user-state arrays into the
+// mapping; a corrupt file is ignored as a whole. A save copies the state into one in-memory
+// image on the calling thread (a few hundred KB of memcpy), then a helper
+// thread writes, fsyncs and renames it into place, so the menu never waits
+// on the disk. (No fork(): the event log writer and catalog watcher make
+// this a multithreaded process.)
+
+// A fully serialized snapshot waiting to be written
+typedef struct {
+    char path[MAX_LEN];
+    char *data;
+    size_t size;
+} SnapshotImage;
+
+static uint64_t snapshot_generation = 0;
+#ifndef _WIN32
+static pthread_t snapshot_writer;
+static int snapshot_writer_active = 0;
+static int snapshot_writer_status = 0;
+#endif
+
+static uint32_t fnv1a32(const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+// Section table in SNAP_* order: where each section lives in memory
+static void snapshot_sources(const void *src[SNAPSHOT_SECTIONS], uint32_t count[SNAPSHOT_SECTIONS],
+                             uint32_t elem_size[SNAPSHOT_SECTIONS]) {
+    src[SNAP_HISTORY] = history;         count[SNAP_HISTORY] = MAX_HISTORY;
+    elem_size[SNAP_HISTORY] = sizeof(HistoryEntry);
+    src[SNAP_RATINGS] = ratings;         count[SNAP_RATINGS] = MAX_RATINGS;
+    elem_size[SNAP_RATINGS] = sizeof(OutfitRating);
+    src[SNAP_FAVORITES] = favorites;     count[SNAP_FAVORITES] = MAX_FAVORITES;
+    elem_size[SNAP_FAVORITES] = sizeof(FavoriteOutfit);
+    src[SNAP_OUTFITS] = NULL;            count[SNAP_OUTFITS] = NUM_CATEGORIES * NUM_OUTFITS;
+    elem_size[SNAP_OUTFITS] = sizeof(Outfit);
+    src[SNAP_ACCESSORIES] = NULL;        count[SNAP_ACCESSORIES] = NUM_CATEGORIES * NUM_ACCESSORIES;
+    elem_size[SNAP_ACCESSORIES] = MAX_LEN;
+    src[SNAP_SHOES] = NULL;              count[SNAP_SHOES] = NUM_CATEGORIES * NUM_SHOES;
+    elem_size[SNAP_SHOES] = MAX_LEN;
+    src[SNAP_JACKETS] = NULL;            count[SNAP_JACKETS] = NUM_CATEGORIES * NUM_JACKETS;
+    elem_size[SNAP_JACKETS] = MAX_LEN;
+    src[SNAP_WARDROBE] = wardrobe;       count[SNAP_WARDROBE] = 1;
+    elem_size[SNAP_WARDROBE] = sizeof(Wardrobe);
+}
+
+// The catalog is split across per-category arrays; these copy it as one block
+static void copy_catalog_out(int section, char *dst) {
+    const Catalog *c = catalog_enter();
+    if (section == SNAP_OUTFITS) memcpy(dst, c->outfits, sizeof(c->outfits));
+    if (section == SNAP_ACCESSORIES) memcpy(dst, c->accessories, sizeof(c->accessories));
+    if (section == SNAP_SHOES) memcpy(dst, c->shoes, sizeof(c->shoes));
+    if (section == SNAP_JACKETS) memcpy(dst, c->jackets, sizeof(c->jackets));
+    catalog_exit();
+}
+
+// Only used at startup, before the catalog watcher runs
+static void copy_catalog_in(int section, const char *src) {
+    Catalog *c = &catalog_store;
+    if (section == SNAP_OUTFITS) memcpy(c->outfits, src, sizeof(c->outfits));
+    if (section == SNAP_ACCESSORIES) memcpy(c->accessories, src, sizeof(c->accessories));
+    if (section == SNAP_SHOES) memcpy(c->shoes, src, sizeof(c->shoes));
+    if (section == SNAP_JACKETS) memcpy(c->jackets, src, sizeof(c->jackets));
+}
+
+// Copy the current state into a page-aligned image; returns 0 on success
+static int serialize_snapshot(const char *path, SnapshotImage *img) {
+    const void *src[SNAPSHOT_SECTIONS];
+    uint32_t count[SNAPSHOT_SECTIONS], elem_size[SNAPSHOT_SECTIONS];
+    SnapshotHeader header;
+
+    snapshot_sources(src, count, elem_size);
+    size_t size = SNAPSHOT_PAGE_SIZE; // Header gets the first page
+    for (int i = 0; i < SNAPSHOT_SECTIONS; i++) {
+        size_t bytes = (size_t)count[i] * elem_size[i];
+        size += (bytes + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE * SNAPSHOT_PAGE_SIZE;
+    }
+    img->data = calloc(1, size);
+    if (!img->data) return -1;
+    img->size = size;
+    strncpy(img->path, path, MAX_LEN - 1);
+    img->path[MAX_LEN - 1] = '\0';
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "OUTFITS", 8);
+    header.version = SNAPSHOT_VERSION;
+    header.page_size = SNAPSHOT_PAGE_SIZE;
+    header.generation = ++snapshot_generation;
+    header.created = (int64_t)clock_now();
+    header.history_count = (uint32_t)history_count;
+    header.rating_count = (uint32_t)rating_count;
+    header.favorite_count = (uint32_t)favorite_count;
+    header.section_count = SNAPSHOT_SECTIONS;
+
+    uint32_t offset = SNAPSHOT_PAGE_SIZE;
+    for (int i = 0; i < SNAPSHOT_SECTIONS; i++) {
+        size_t bytes = (size_t)count[i] * elem_size[i];
+        char *dst = img->data + offset;
+        if (src[i]) memcpy(dst, src[i], bytes);
+        else copy_catalog_out(i, dst);
+        header.sections[i] = (SnapshotSection){offset, count[i], elem_size[i], fnv1a32(dst, bytes)};
+        offset += (uint32_t)((bytes + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE * SNAPSHOT_PAGE_SIZE);
+    }
+    header.header_checksum = fnv1a32(&header, offsetof(SnapshotHeader, header_checksum));
+    memcpy(img->data, &header, sizeof(header));
+    return 0;
+}
+
+// Write an image to a temp file, fsync it and rename it into place; frees the image
+static int write_snapshot_image(SnapshotImage *img) {
+    char tmp_path[MAX_LEN + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", img->path);
+    FILE *fp = fopen(tmp_path, "wb");
+    int ok = fp && fwrite(img->data, 1, img->size, fp) == img->size && fflush(fp) == 0;
+#ifndef _WIN32
+    ok = ok && fsync(fileno(fp)) == 0;
+#endif
+    if (fp) ok = (fclose(fp) == 0) && ok;
+    ok = ok && rename(tmp_path, img->path) == 0;
+    if (!ok) remove(tmp_path);
+    free(img->data);
+    img->data = NULL;
+    return ok ? 0 : -1;
+}
+
+// Write the current state synchronously (temp file + rename)
+int save_snapshot(const char *path) {
+    SnapshotImage img;
+    if (serialize_snapshot(path, &img) != 0) return -1;
+    return write_snapshot_image(&img);
+}
+
+#ifndef _WIN32
+static void *snapshot_writer_main(void *arg) {
+    SnapshotImage *img = arg;
+    snapshot_writer_status = write_snapshot_image(img);
+    free(img);
+    return NULL;
+}
+#endif
+
+// Serialize the state now and write it on a helper thread
+int save_snapshot_async(const char *path) {
+#ifdef _WIN32
+    return save_snapshot(path);
+#else
+    wait_for_snapshot(); // One writer at a time keeps the renames ordered
+    SnapshotImage *img = malloc(sizeof(SnapshotImage));
+    if (!img || serialize_snapshot(path, img) != 0) {
+        free(img);
+        return -1;
+    }
+    if (pthread_create(&snapshot_writer, NULL, snapshot_writer_main, img) != 0) {
+        int rc = write_snapshot_image(img); // Fall back to writing it here
+        free(img);
+        return rc;
+    }
+    snapshot_writer_active = 1;
+    return 0;
+#endif
+}
+
+void wait_for_snapshot() {
+#ifndef _WIN32
+    if (snapshot_writer_active) {
+        pthread_join(snapshot_writer, NULL);
+        snapshot_writer_active = 0;
+        if (snapshot_writer_status != 0)
+            printf(RED "\nWarning: saving the state snapshot failed.\n" RESET);
+    }
+#endif
+}
+
+static const SnapshotHeader *check_snapshot_header(const void *data, size_t size) {
+    const SnapshotHeader *h = data;
+    const void *src[SNAPSHOT_SECTIONS];
+    uint32_t count[SNAPSHOT_SECTIONS], elem_size[SNAPSHOT_SECTIONS];
+
+    if (size < sizeof(SnapshotHeader) || memcmp(h->magic, "OUTFITS", 8) != 0 ||
+        h->version != SNAPSHOT_VERSION || h->page_size != SNAPSHOT_PAGE_SIZE ||
+        h->section_count != SNAPSHOT_SECTIONS ||
+        h->header_checksum != fnv1a32(h, offsetof(SnapshotHeader, header_checksum)) ||
+        h->history_count > MAX_HISTORY || h->rating_count > MAX_RATINGS || h->favorite_count > MAX_FAVORITES)
+        return NULL;
+
+    // Layouts must match this build exactly; anything else is a different format
+    snapshot_sources(src, count, elem_size);
+    for (int i = 0; i < SNAPSHOT_SECTIONS; i++) {
+        const SnapshotSection *sec = &h->sections[i];
+        if (sec->count != count[i] || sec->elem_size != elem_size[i] || sec->offset % SNAPSHOT_PAGE_SIZE != 0 ||
+            (size_t)sec->offset + (size_t)sec->count * sec->elem_size > size)
+            return NULL;
+    }
+    return h;
+}
+
+// Index of the first section whose data does not match its checksum, or -1
+static int find_corrupt_section(const SnapshotHeader *h, const char *data) {
+    for (int i = 0; i < SNAPSHOT_SECTIONS; i++) {
+        const SnapshotSection *sec = &h->sections[i];
+        if (fnv1a32(data + sec->offset, (size_t)sec->count * sec->elem_size) != sec->checksum) return i;
+    }
+    return -1;
+}
+
+// Map a snapshot and adopt it as the live state; returns 0 on success.
+// Nothing is adopted unless the header and every section check out.
+int load_snapshot(const char *path) {
+    void *data = NULL;
+    size_t size = 0;
+
+#ifdef _WIN32
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return -1;
+    fseek(fp, 0, SEEK_END);
+    size = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    data = malloc(size ? size : 1);
+    if (!data || fread(data, 1, size, fp) != size) {
+        free(data);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        size = (size_t)st.st_size;
+        // Private writable mapping: edits stay in memory until the next save
+        data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) data = NULL;
+    }
+    close(fd);
+    if (!data) return -1;
+#endif
+
+    const SnapshotHeader *h = check_snapshot_header(data, size);
+    int corrupt = h ? find_corrupt_section(h, data) : -1;
+    if (!h || corrupt >= 0) {
+        if (corrupt >= 0) printf(RED "Snapshot section %d is corrupt\n" RESET, corrupt);
+        printf(RED "Ignoring invalid state snapshot %s\n" RESET, path);
+#ifdef _WIN32
+        free(data);
+#else
+        munmap(data, size);
+#endif
+        return -1;
+    }
+
+    char *base = data;
+    history = (HistoryEntry *)(base + h->sections[SNAP_HISTORY].offset);
+    ratings = (OutfitRating *)(base + h->sections[SNAP_RATINGS].offset);
+    favorites = (FavoriteOutfit *)(base + h->sections[SNAP_FAVORITES].offset);
+    wardrobe = (Wardrobe *)(base + h->sections[SNAP_WARDROBE].offset);
+    history_count = (int)h->history_count;
+    rating_count = (int)h->rating_count;
+    favorite_count = (int)h->favorite_count;
+    for (int i = SNAP_OUTFITS; i <= SNAP_JACKETS; i++) copy_catalog_in(i, base + h->sections[i].offset);
+
+    snapshot_generation = h->generation;
+    return 0;
+}
+
+// Full integrity check of every section; returns 0 if the file is intact
+int verify_snapshot(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        printf(RED "Could not open %s\n" RESET, path);
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    size_t size = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *data = malloc(size ? size : 1);
+    int ok = data && fread(data, 1, size, fp) == size;
+    fclose(fp);
+
+    const SnapshotHeader *h = ok ? check_snapshot_header(data, size) : NULL;
+    int corrupt = h ? find_corrupt_section(h, data) : -1;
+    if (corrupt >= 0) {
+        printf(RED "Snapshot section %d is corrupt\n" RESET, corrupt);
+        h = NULL;
+    }
+    if (h) {
+        printf(GREEN "Snapshot OK: generation %llu, %u history, %u ratings, %u favorites\n" RESET,
+               (unsigned long long)h->generation, h->history_count, h->rating_count, h->favorite_count);
+    } else {
+        printf(RED "Snapshot %s failed verification\n" RESET, path);
+    }
+    free(data);
+    return h ? 0 : -1;
+}
+
+// =============================
+// COLUMNAR HISTORY ANALYTICS
+// =============================
+// Every history entry is also appended to history_columns with its strings
+// dictionary-encoded. The columns are built on first use (the analytics
+// view or a query) rather than at startup, since that means decompressing
+// every cold segment; until then new entries are not appended, as the
+// first build picks them up from the history itself. Queries split the rows into one partition per core;
+// each thread filters a block of rows into a selection vector with a
+// branch-free loop, aggregates the selected rows into private group
+// counters, and the partials are summed at the end.
+
+typedef struct {
+    int kind;
+    int32_t day_from;
+    int32_t day_to;
+    size_t begin;
+    size_t end;
+    QueryResult partial;
+} AnalyticsTask;
+
+static int analytics_loaded = 0; // history_columns cover the whole history
+
+int dict_encode(Dictionary *dict, const char *name) {
+    unsigned slot = fnv1a32(name, strlen(name)) % DICT_HASH_SLOTS;
+    while (dict->slots[slot] != 0) {
+        int id = dict->slots[slot] - 1;
+        if (strcmp(dict->names[id], name) == 0) return id;
+        slot = (slot + 1) % DICT_HASH_SLOTS;
+    }
+    if (dict->count >= MAX_DICT_ENTRIES) return -1;
+    if (!dict->names && !(dict->names = calloc(MAX_DICT_ENTRIES, MAX_LEN))) return -1;
+
+    strncpy(dict->names[dict->count], name, MAX_LEN - 1);
+    dict->slots[slot] = (uint16_t)(dict->count + 1);
+    return dict->count++;
+}
+
+static int grow_history_columns(HistoryColumns *c) {
+    size_t cap = c->capacity ? c->capacity * 2 : 1024;
+    void *p;
+#define GROW_COLUMN(col) \
+    if (!(p = realloc(c->col, cap * sizeof(*c->col)))) return -1; \
+    c->col = p;
+    GROW_COLUMN(day) GROW_COLUMN(temp) GROW_COLUMN(outfit) GROW_COLUMN(jacket)
+    GROW_COLUMN(mood) GROW_COLUMN(month) GROW_COLUMN(condition) GROW_COLUMN(category)
+#undef GROW_COLUMN
+    c->capacity = cap;
+    return 0;
+}
+
+int analytics_append_row(const HistoryRow *row) {
+    HistoryColumns *c = &history_columns;
+    const char *mood_name = row->fields[HISTORY_FIELD_MOOD];
+    int outfit = dict_encode(&outfit_dict, row->fields[HISTORY_FIELD_OUTFIT]);
+    int jacket = dict_encode(&jacket_dict, row->fields[HISTORY_FIELD_JACKET]);
+    int mood = dict_encode(&mood_dict, mood_name[0] ? mood_name : "(none)");
+    if (outfit < 0 || jacket < 0 || mood < 0) return -1;
+    if (c->count == c->capacity && grow_history_columns(c) != 0) return -1;
+
+    DateContext ctx;
+    build_date_context((time_t)row->timestamp, row->fields[HISTORY_FIELD_CITY], &ctx);
+    size_t i = c->count++;
+    c->day[i] = (int32_t)days_from_civil(ctx.local.tm_year + 1900, ctx.local.tm_mon + 1, ctx.local.tm_mday);
+    c->temp[i] = row->temp;
+    c->outfit[i] = (uint16_t)outfit;
+    c->jacket[i] = (uint16_t)jacket;
+    c->mood[i] = (uint16_t)mood;
+    c->month[i] = (uint8_t)ctx.local.tm_mon;
+    c->condition[i] = (uint8_t)get_condition_index(row->fields[HISTORY_FIELD_CONDITION]);
+    c->category[i] = (uint8_t)get_category_index(row->temp);
+    return 0;
+}
+
+int analytics_append(const HistoryEntry *entry) {
+    if (!analytics_loaded) return 0; // analytics_load_history() will see it
+    HistoryRow row;
+    history_row(entry, &row);
+    return analytics_append_row(&row);
+}
+
+static int append_archived_row(const HistoryRow *row, void *user) {
+    (void)user;
+    return analytics_append_row(row) == 0;
+}
+
+// First use: build the columns from the cold tier (segments and staging)
+// and then the hot tier, so queries cover the whole history. Runs once.
+void analytics_load_history() {
+    if (analytics_loaded) return;
+    analytics_loaded = 1;
+    cold_history_scan_rows(INT64_MIN, INT64_MAX, append_archived_row, NULL);
+    for (int i = 0; i < history_count; i++) analytics_append(&history[i]);
+}
+
+static int query_groups(int kind) {
+    if (kind == QUERY_JACKETS_BY_CONDITION_MONTH) return NUM_CONDITIONS * 12 * (jacket_dict.count ? jacket_dict.count : 1);
+    if (kind == QUERY_AVG_TEMP_BY_OUTFIT) return outfit_dict.count ? outfit_dict.count : 1;
+    return NUM_CATEGORIES * (mood_dict.count ? mood_dict.count : 1);
+}
+
+static void *analytics_scan(void *arg) {
+    AnalyticsTask *t = arg;
+    const HistoryColumns *c = &history_columns;
+    uint64_t *counts = t->partial.counts;
+    double *sums = t->partial.sums;
+    int jackets = jacket_dict.count, moods = mood_dict.count;
+    uint32_t sel[ANALYTICS_BLOCK];
+
+    for (size_t base = t->begin; base < t->end; base += ANALYTICS_BLOCK) {
+        size_t rows = t->end - base < ANALYTICS_BLOCK ? t->end - base : ANALYTICS_BLOCK;
+        const int32_t *day = c->day + base;
+
+        // Filter: selection vector of rows whose day is in range
+        size_t n = 0;
+        for (size_t i = 0; i < rows; i++) {
+            sel[n] = (uint32_t)i;
+            n += (day[i] >= t->day_from) & (day[i] <= t->day_to);
+        }
+
+        // Group-by + aggregate over the selected rows
+        if (t->kind == QUERY_JACKETS_BY_CONDITION_MONTH) {
+            const uint8_t *cond = c->condition + base, *month = c->month + base;
+            const uint16_t *jacket = c->jacket + base;
+            for (size_t k = 0; k < n; k++) {
+                uint32_t i = sel[k];
+                counts[(cond[i] * 12 + month[i]) * jackets + jacket[i]]++;
+            }
+        } else if (t->kind == QUERY_AVG_TEMP_BY_OUTFIT) {
+            const uint16_t *outfit = c->outfit + base;
+            const float *temp = c->temp + base;
+            for (size_t k = 0; k < n; k++) {
+                uint32_t i = sel[k];
+                counts[outfit[i]]++;
+                sums[outfit[i]] += temp[i];
+            }
+        } else {
+            const uint8_t *category = c->category + base;
+            const uint16_t *mood = c->mood + base;
+            for (size_t k = 0; k < n; k++) {
+                uint32_t i = sel[k];
+                counts[category[i] * moods + mood[i]]++;
+            }
+        }
+    }
+    return NULL;
+}
+
+static int alloc_query_result(QueryResult *r, int kind) {
+    r->kind = kind;
+    r->groups = query_groups(kind);
+    r->counts = calloc((size_t)r->groups, sizeof(uint64_t));
+    r->sums = kind == QUERY_AVG_TEMP_BY_OUTFIT ? calloc((size_t)r->groups, sizeof(double)) : NULL;
+    return r->counts && (kind != QUERY_AVG_TEMP_BY_OUTFIT || r->sums) ? 0 : -1;
+}
+
+void free_query_result(QueryResult *result) {
+    free(result->counts);
+    free(result->sums);
+    result->counts = NULL;
+    result->sums = NULL;
+}
+
+// Run a group-by over history rows with day_from <= day <= day_to
+int analytics_query(int kind, int32_t day_from, int32_t day_to, QueryResult *result) {
+    analytics_load_history();
+    size_t rows = history_columns.count;
+    int threads = 1;
+#ifndef _WIN32
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (int)(rows / ANALYTICS_MIN_ROWS_PER_THREAD) + 1;
+    if (threads > cores) threads = cores < 1 ? 1 : (int)cores;
+    if (threads > MAX_IMPORT_THREADS) threads = MAX_IMPORT_THREADS;
+#endif
+
+    AnalyticsTask tasks[MAX_IMPORT_THREADS];
+    int status = alloc_query_result(result, kind);
+    for (int i = 0; i < threads; i++) {
+        tasks[i] = (AnalyticsTask){kind, day_from, day_to, rows * i / threads, rows * (i + 1) / threads, {0}};
+        // Partition 0 aggregates straight into the result
+        if (i == 0) tasks[i].partial = *result;
+        else if (alloc_query_result(&tasks[i].partial, kind) != 0) status = -1;
+    }
+    if (status != 0) {
+        for (int i = 1; i < threads; i++) free_query_result(&tasks[i].partial);
+        free_query_result(result);
+        return -1;
+    }
+
+#ifndef _WIN32
+    pthread_t workers[MAX_IMPORT_THREADS];
+    int started[MAX_IMPORT_THREADS] = {0};
+    for (int i = 1; i < threads; i++) {
+        started[i] = pthread_create(&workers[i], NULL, analytics_scan, &tasks[i]) == 0;
+        if (!started[i]) analytics_scan(&tasks[i]);
+    }
+#endif
+    analytics_scan(&tasks[0]);
+    for (int i = 1; i < threads; i++) {
+#ifndef _WIN32
+        if (started[i]) pthread_join(workers[i], NULL);
+#endif
+        for (int g = 0; g < result->groups; g++) {
+            result->counts[g] += tasks[i].partial.counts[g];
+            if (result->sums) result->sums[g] += tasks[i].partial.sums[g];
+        }
+        free_query_result(&tasks[i].partial);
+    }
+    return 0;
+}
+
+void show_wardrobe_analytics() {
+    QueryResult r;
+    analytics_load_history();
+    if (history_columns.count == 0) {
+        printf(YELLOW "\nNo history to analyze yet.\n" RESET);
+        return;
+    }
+
+    printf(CYAN "\n--- Wardrobe Analytics (%zu entries) ---\n" RESET, history_columns.count);
+    const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+    if (analytics_query(QUERY_JACKETS_BY_CONDITION_MONTH, INT32_MIN, INT32_MAX, &r) == 0) {
+        printf(YELLOW "\nMost-worn jacket by condition and month:\n" RESET);
+        for (int c = 0; c < NUM_CONDITIONS; c++) {
+            for (int m = 0; m < 12; m++) {
+                uint64_t *row = &r.counts[(c * 12 + m) * jacket_dict.count];
+                int best = 0;
+                for (int j = 1; j < jacket_dict.count; j++) {
+                    if (row[j] > row[best]) best = j;
+                }
+                if (jacket_dict.count > 0 && row[best] > 0)
+                    printf("%-7s %s: %s (%llu)\n", conditions[c], months[m], jacket_dict.names[best],
+                           (unsigned long long)row[best]);
+            }
+        }
+        free_query_result(&r);
+    }
+
+    if (analytics_query(QUERY_AVG_TEMP_BY_OUTFIT, INT32_MIN, INT32_MAX, &r) == 0) {
+        printf(YELLOW "\nAverage temperature per outfit:\n" RESET);
+        for (int o = 0; o < outfit_dict.count; o++) {
+            if (r.counts[o] > 0)
+                printf("%-20s %.1f°C over %llu wear(s)\n", outfit_dict.names[o], r.sums[o] / r.counts[o],
+                       (unsigned long long)r.counts[o]);
+        }
+        free_query_result(&r);
+    }
+
+    if (analytics_query(QUERY_MOOD_BY_CATEGORY, INT32_MIN, INT32_MAX, &r) == 0) {
+        printf(YELLOW "\nMood distribution by category:\n" RESET);
+        for (int c = 0; c < NUM_CATEGORIES; c++) {
+            uint64_t total = 0;
+            for (int m = 0; m < mood_dict.count; m++) total += r.counts[c * mood_dict.count + m];
+            if (total == 0) continue;
+            printf("%s:", categories[c]);
+            for (int m = 0; m < mood_dict.count; m++) {
+                uint64_t n = r.counts[c * mood_dict.count + m];
+                if (n > 0) printf(" %s %.0f%%", mood_dict.names[m], 100.0 * n / total);
+            }
+            printf("\n");
+        }
+        free_query_result(&r);
+    }
+}
+
+// Command-line check: fill the column store with synthetic rows and time each query
+int run_analytics_benchmark(long long rows) {
+    Outfit *outfits[NUM_CATEGORIES] = {cold_outfits, moderate_outfits, hot_outfits};
+    char (*jackets[NUM_CATEGORIES])[MAX_LEN] = {cold_jackets, moderate_jackets, hot_jackets};
+    const char *moods[] = {"happy", "energetic", "laid-back", "tired", ""};
+    HistoryEntry h;
+
+    analytics_loaded = 1; // Synthetic rows only, no history to build from
+    // Encode the dictionaries once, then bulk-fill the columns directly
+    memset(&h, 0, sizeof(h));
+    for (int c = 0; c < NUM_CATEGORIES; c++) {
+        for (int i = 0; i < NUM_OUTFITS; i++) dict_encode(&outfit_dict, outfits[c][i].title);
+        for (int i = 0; i < NUM_JACKETS; i++) dict_encode(&jacket_dict, jackets[c][i]);
+    }
+    for (int i = 0; i < 5; i++) dict_encode(&mood_dict, moods[i][0] ? moods[i] : "(none)");
+
+    HistoryColumns *c = &history_columns;
+    uint32_t seed = 12345;
+    while (c->count < (size_t)rows) {
+        if (c->count == c->capacity && grow_history_columns(c) != 0) {
+            printf(RED "Out of memory after %zu rows\n" RESET, c->count);
+            return -1;
+        }
+        size_t i = c->count++;
+        seed = seed * 1103515245u + 12345u;
+        int category = (seed >> 8) % NUM_CATEGORIES;
+        c->day[i] = 18000 + (int32_t)((seed >> 4) % 3650);
+        c->temp[i] = category * 15.0f - 5.0f + (float)((seed >> 16) % 150) / 10.0f;
+        c->outfit[i] = (uint16_t)(category * NUM_OUTFITS + (seed >> 12) % NUM_OUTFITS);
+        c->jacket[i] = (uint16_t)(category * NUM_JACKETS + (seed >> 20) % NUM_JACKETS);
+        c->mood[i] = (uint16_t)((seed >> 24) % 5);
+        c->month[i] = (uint8_t)((seed >> 6) % 12);
+        c->condition[i] = (uint8_t)((seed >> 28) % NUM_CONDITIONS);
+        c->category[i] = (uint8_t)category;
+    }
+
+    printf(CYAN "\n--- Analytics Benchmark (%lld rows) ---\n" RESET, rows);
+    const char *names[] = {"", "jackets by condition/month", "avg temp by outfit", "mood by category"};
+    for (int kind = QUERY_JACKETS_BY_CONDITION_MONTH; kind <= QUERY_MOOD_BY_CATEGORY; kind++) {
+        QueryResult r;
+        double start = monotonic_seconds();
+        if (analytics_query(kind, 18000, 18000 + 1825, &r) != 0) return -1;
+        printf("%-28s %.3f s\n", names[kind], monotonic_seconds() - start);
+        free_query_result(&r);
+    }
+    return 0;
+}
+
+// =============================
+// WARDROBE INVENTORY
+// =============================
+// Every catalog item has a dense ID (kind, then category, then index), so a
+// user's ownership, laundry and recently-worn state are bitsets over the
+// whole catalog. Candidates for a request are owned & ~laundry & ~recent &
+// weather-valid, computed a word at a time before anything is shown.
+
+static void itemset_add(ItemSet *set, int id) {
+    set->words[id / 64] |= 1ULL << (id % 64);
+}
+
+static void itemset_remove(ItemSet *set, int id) {
+    set->words[id / 64] &= ~(1ULL << (id % 64));
+}
+
+static int itemset_has(const ItemSet *set, int id) {
+    return (set->words[id / 64] >> (id % 64)) & 1;
+}
+
+int catalog_item_id(int kind, int category, int index) {
+    return item_kind_offset[kind] + category * item_kind_count[kind] + index;
+}
+
+// The name lives in the current catalog; call inside catalog_enter()/catalog_exit()
+const char* catalog_item_name(int id) {
+    int kind = NUM_ITEM_KINDS - 1;
+    while (id < item_kind_offset[kind]) kind--;
+    int local = id - item_kind_offset[kind];
+    int category = local / item_kind_count[kind], index = local % item_kind_count[kind];
+
+    const Catalog *c = current_catalog();
+    if (kind == ITEM_OUTFIT) return c->outfits[category][index].title;
+    if (kind == ITEM_ACCESSORY) return c->accessories[category][index];
+    if (kind == ITEM_SHOE) return c->shoes[category][index];
+    return c->jackets[category][index];
+}
+
+void init_catalog_sets() {
+    for (int c = 0; c < NUM_CATEGORIES; c++) {
+        memset(&weather_valid_items[c], 0, sizeof(ItemSet));
+        for (int kind = 0; kind < NUM_ITEM_KINDS; kind++) {
+            for (int i = 0; i < item_kind_count[kind]; i++) itemset_add(&weather_valid_items[c], catalog_item_id(kind, c, i));
+        }
+    }
+}
+
+// New users own the whole catalog until they say otherwise
+void init_wardrobe(Wardrobe *w) {
+    memset(w, 0, sizeof(*w));
+    for (int id = 0; id < CATALOG_ITEMS; id++) itemset_add(&w->owned, id);
+}
+
+int32_t current_day() {
+    return (int32_t)days_from_civil(date_ctx.local.tm_year + 1900, date_ctx.local.tm_mon + 1, date_ctx.local.tm_mday);
+}
+
+ItemSet wardrobe_candidates(Wardrobe *w, int category, int32_t today) {
+    if (w->recent_day != today) {
+        memset(&w->worn_recently, 0, sizeof(ItemSet));
+        for (int id = 0; id < CATALOG_ITEMS; id++) {
+            if (w->last_worn_day[id] != 0 && today - w->last_worn_day[id] <= WEAR_COOLDOWN_DAYS)
+                itemset_add(&w->worn_recently, id);
+        }
+        w->recent_day = today;
+    }
+
+    ItemSet out;
+    for (int i = 0; i < ITEM_SET_WORDS; i++)
+        out.words[i] = w->owned.words[i] & ~w->laundry.words[i] & ~w->worn_recently.words[i] &
+                       weather_valid_items[category].words[i];
+    return out;
+}
+
+// Indices (within the category) of the candidate items of one kind;
+// falls back to every item when none is available
+int list_candidates(const ItemSet *candidates, int kind, int category, int out[]) {
+    int n = 0;
+    for (int i = 0; i < item_kind_count[kind]; i++) {
+        if (itemset_has(candidates, catalog_item_id(kind, category, i))) out[n++] = i;
+    }
+    if (n == 0) {
+        printf(YELLOW "(No available %s - showing everything)\n" RESET, item_kind_names[kind]);
+        for (; n < item_kind_count[kind]; n++) out[n] = n;
+    }
+    return n;
+}
+
+void record_wear(Wardrobe *w, const int ids[], int count, int32_t today) {
+    for (int i = 0; i < count; i++) {
+        w->wear_count[ids[i]]++;
+        w->last_worn_day[ids[i]] = today;
+        itemset_add(&w->worn_recently, ids[i]);
+    }
+}
+
+void manage_wardrobe() {
+    catalog_enter();
+    while (1) {
+        printf(CYAN "\n--- My Wardrobe ---\n" RESET);
+        for (int kind = 0; kind < NUM_ITEM_KINDS; kind++) {
+            printf(YELLOW "%s:\n" RESET, item_kind_names[kind]);
+            for (int c = 0; c < NUM_CATEGORIES; c++) {
+                for (int i = 0; i < item_kind_count[kind]; i++) {
+                    int id = catalog_item_id(kind, c, i);
+                    printf("%2d. %-22s %-9s %s%s worn %u time(s)", id + 1, catalog_item_name(id), categories[c],
+                           itemset_has(&wardrobe->owned, id) ? "[owned]" : "[-----]",
+                           itemset_has(&wardrobe->laundry, id) ? "[laundry]" : "         ", wardrobe->wear_count[id]);
+                    if (wardrobe->last_worn_day[id] != 0) {
+                        char date[MAX_LEN];
+                        struct tm tm_info;
+                        time_t t = (time_t)wardrobe->last_worn_day[id] * 86400;
+                        gmtime_r(&t, &tm_info);
+                        strftime(date, MAX_LEN, "%Y-%m-%d", &tm_info);
+                        printf(", last %s", date);
+                    }
+                    printf("\n");
+                }
+            }
+        }
+
+        printf("\n1. Toggle ownership\n2. Move item to/from laundry\n3. Laundry done (clear all)\n4. Back\n");
+        int choice = get_valid_choice(4);
+        if (choice == 4) break;
+        if (choice == 3) {
+            memset(&wardrobe->laundry, 0, sizeof(ItemSet));
+            continue;
+        }
+        printf("Which item? (1-%d): ", CATALOG_ITEMS);
+        int id = get_valid_choice(CATALOG_ITEMS) - 1;
+        ItemSet *set = choice == 1 ? &wardrobe->owned : &wardrobe->laundry;
+        if (itemset_has(set, id)) itemset_remove(set, id);
+        else itemset_add(set, id);
+    }
+    catalog_exit();
+}
+
+// =============================
+// EVENT CALENDAR
+// =============================
+// Events are kept as [start, end] intervals in two indexes: one-off events
+// by absolute day, recurring ones by day of a leap year (an event that
+// wraps past New Year is split in two). Each index is sorted by start and
+// annotated with subtree max ends, so finding the events active on a day
+// visits O(log n) entries plus the matches.
+//
+// events.csv lines: name,start,end,style,colors,description
+// where start/end are YYYY-MM-DD (one-off) or MM-DD (every year).
+
+static int compare_intervals(const void *a, const void *b) {
+    int32_t x = ((const EventInterval *)a)->start, y = ((const EventInterval *)b)->start;
+    return (x > y) - (x < y);
+}
+
+static int32_t build_max_end(IntervalIndex *idx, int lo, int hi) {
+    int mid = (lo + hi) / 2;
+    int32_t m = idx->items[mid].end;
+    if (lo < mid) {
+        int32_t left = build_max_end(idx, lo, mid - 1);
+        if (left > m) m = left;
+    }
+    if (mid < hi) {
+        int32_t right = build_max_end(idx, mid + 1, hi);
+        if (right > m) m = right;
+    }
+    idx->max_end[mid] = m;
+    return m;
+}
+
+static int add_interval(IntervalIndex *idx, int32_t start, int32_t end, int event) {
+    if (idx->count == idx->capacity) {
+        int cap = idx->capacity ? idx->capacity * 2 : 64;
+        EventInterval *items = realloc(idx->items, cap * sizeof(EventInterval));
+        if (!items) return -1;
+        idx->items = items;
+        int32_t *max_end = realloc(idx->max_end, cap * sizeof(int32_t));
+        if (!max_end) return -1;
+        idx->max_end = max_end;
+        idx->capacity = cap;
+    }
+    idx->items[idx->count++] = (EventInterval){start, end, event};
+    idx->dirty = 1;
+    return 0;
+}
+
+static int stab_intervals(const IntervalIndex *idx, int lo, int hi, int32_t day, int out[], int n, int max) {
+    while (lo <= hi && n < max) {
+        int mid = (lo + hi) / 2;
+        if (idx->max_end[mid] < day) return n; // Nothing in this subtree reaches day
+        n = stab_intervals(idx, lo, mid - 1, day, out, n, max);
+        if (idx->items[mid].start > day) return n; // Everything to the right starts later
+        if (idx->items[mid].end >= day && n < max) out[n++] = idx->items[mid].event;
+        lo = mid + 1;
+    }
+    return n;
+}
+
+static int query_intervals(IntervalIndex *idx, int32_t day, int out[], int n, int max) {
+    if (idx->count == 0) return n;
+    if (idx->dirty) {
+        qsort(idx->items, idx->count, sizeof(EventInterval), compare_intervals);
+        build_max_end(idx, 0, idx->count - 1);
+        idx->dirty = 0;
+    }
+    return stab_intervals(idx, 0, idx->count - 1, day, out, n, max);
+}
+
+static int32_t day_of_leap_year(int month, int day) {
+    return (int32_t)(days_from_civil(2000, month, day) - days_from_civil(2000, 1, 1));
+}
+
+// Parses "YYYY-MM-DD" (returns 1) or "MM-DD" (returns 2) into a day number.
+// MM-DD recurs every year, so 02-29 is allowed there.
+static int parse_calendar_date(const char *text, int32_t *out) {
+    int y, m, d;
+    char extra;
+    if (sscanf(text, "%4d-%2d-%2d%c", &y, &m, &d, &extra) == 3 && m >= 1 && m <= 12 && d >= 1 &&
+        d <= days_in_month(y, m)) {
+        *out = (int32_t)days_from_civil(y, m, d);
+        return 1;
+    }
+    if (sscanf(text, "%2d-%2d%c", &m, &d, &extra) == 2 && m >= 1 && m <= 12 && d >= 1 &&
+        d <= days_in_month(2000, m)) {
+        *out = day_of_leap_year(m, d);
+        return 2;
+    }
+    return 0;
+}
+
+// Add an event; start and end must both be YYYY-MM-DD or both MM-DD
+int add_calendar_event(const SpecialEvent *info, int style, const char *start, const char *end) {
+    int32_t from, to;
+    int kind = parse_calendar_date(start, &from);
+    if (kind == 0 || parse_calendar_date(end, &to) != kind || (kind == 1 && to < from)) return -1;
+
+    if (calendar_event_count == calendar_event_capacity) {
+        int cap = calendar_event_capacity ? calendar_event_capacity * 2 : 64;
+        CalendarEvent *events = realloc(calendar_events, cap * sizeof(CalendarEvent));
+        if (!events) return -1;
+        calendar_events = events;
+        calendar_event_capacity = cap;
+    }
+    int id = calendar_event_count++;
+    calendar_events[id].info = *info;
+    calendar_events[id].style = style;
+    calendar_events[id].recurring = kind == 2;
+
+    if (kind == 1) return add_interval(&dated_event_index, from, to, id);
+    if (from <= to) return add_interval(&yearly_event_index, from, to, id);
+    // Wraps past New Year, e.g. 12-15 to 01-01
+    if (add_interval(&yearly_event_index, from, 365, id) != 0) return -1;
+    return add_interval(&yearly_event_index, 0, to, id);
+}
+
+static void copy_csv_field(char *dst, const char *src, size_t len) {
+    if (len > MAX_LEN - 1) len = MAX_LEN - 1;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+// Load events from a CSV file; returns the number added or -1 if unreadable
+int load_event_calendar(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    char line[MAX_LEN * 5];
+    int added = 0, line_no = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line_no++;
+        if (!strchr(line, '\n') && !feof(fp)) {
+            // Longer than the buffer: skip the rest rather than reading it as another event
+            int c;
+            while ((c = fgetc(fp)) != EOF && c != '\n');
+            printf(RED "%s:%d: line too long\n" RESET, path, line_no);
+            continue;
+        }
+        strip_newline(line);
+        size_t len = strlen(line);
+        if (len > 0 && line[len - 1] == '\r') line[len - 1] = '\0';
+        if (line[0] == '\0' || line[0] == '#' || strncmp(line, "name,", 5) == 0) continue;
+
+        // name,start,end,style,colors,description (description may contain commas)
+        char fields[5][MAX_LEN];
+        const char *p = line;
+        int f = 0;
+        for (; f < 5; f++) {
+            const char *comma = strchr(p, ',');
+            if (!comma) break;
+            copy_csv_field(fields[f], p, (size_t)(comma - p));
+            p = comma + 1;
+        }
+        if (f < 5) {
+            printf(RED "%s:%d: expected 6 fields\n" RESET, path, line_no);
+            continue;
+        }
+
+        SpecialEvent info;
+        memset(&info, 0, sizeof(info));
+        copy_csv_field(info.name, fields[0], strlen(fields[0]));
+        copy_csv_field(info.color_scheme, fields[4], strlen(fields[4]));
+        copy_csv_field(info.description, p, strlen(p));
+        int style = STYLE_CASUAL;
+        for (int s = 0; s < NUM_STYLES; s++) {
+            if (compare_names_ci(fields[3], style_names[s]) == 0) style = s;
+        }
+        snprintf(info.outfit_suggestion, MAX_LEN, "A %s look matched to the day's weather", style_names[style]);
+
+        if (add_calendar_event(&info, style, fields[1], fields[2]) == 0) added++;
+        else printf(RED "%s:%d: invalid dates\n" RESET, path, line_no);
+    }
+    fclose(fp);
+    return added;
+}
+
+// Built-in events plus anything in EVENT_CALENDAR_FILE
+void init_event_calendar() {
+    for (int i = 0; i < NUM_SPECIAL_EVENTS; i++) {
+        add_calendar_event(&special_events[i], special_event_styles[i], special_event_dates[i][0], special_event_dates[i][1]);
+    }
+    load_event_calendar(EVENT_CALENDAR_FILE);
+}
+
+// Indices of events active on a day (days since 1970-01-01); returns the count
+int find_active_events(int32_t day, int out[], int max) {
+    time_t t = (time_t)day * 86400;
+    struct tm tm_info;
+    gmtime_r(&t, &tm_info);
+
+    int n = query_intervals(&dated_event_index, day, out, 0, max);
+    return query_intervals(&yearly_event_index, day_of_leap_year(tm_info.tm_mon + 1, tm_info.tm_mday), out, n, max);
+}
+
+// =============================
+// TIERED HISTORY STORAGE
+// =============================
+// The hot tier is history[] (the newest MAX_HISTORY entries, in memory and
+// in the snapshot). Entries pushed out of it are staged and then sealed,
+// COLD_SEGMENT_ROWS at a time, into an immutable history-NNNNNN.seg file:
+//   u32 string count, then each string as u8 length + bytes
+//   timestamps: first as a varint, then zigzag varint deltas
+//   temperatures: zigzag varints in tenths of a degree
+//   COLD_FIELDS columns of varint string IDs (one column per field)
+// and the whole block is compressed with a small LZ77 coder (LZ4-style
+// tokens). Only segment headers stay in memory; a date-range scan skips
+// every segment whose [min, max] timestamp misses the range.
+//
+// Staged entries are appended (and fsynced) to COLD_STAGING_FILE as they
+// are evicted, so a crash loses nothing and there is no seal at exit. Its
+// header names the segment number the entries will be sealed as: if that
+// segment already exists at startup, the seal finished but the reset did
+// not, and the staged copies are dropped. A short last segment (from an
+// older build) is folded back into staging at startup and resealed once it
+// is full, so small segments do not pile up. The benchmark archives into a
+// scratch directory and never touches these files.
+
+static const char *cold_field(const HistoryEntry *h, int field) {
+    switch (field) {
+        case 0: return h->outfit.title;
+        case 1: return h->outfit.items[0];
+        case 2: return h->outfit.items[1];
+        case 3: return h->outfit.items[2];
+        case 4: return h->accessory;
+        case 5: return h->shoe;
+        case 6: return h->jacket;
+        case 7: return h->weather.city;
+        case 8: return h->weather.condition;
+        case 9: return h->user_note;
+        default: return h->mood;
+    }
+}
+
+static char *cold_field_dest(HistoryEntry *h, int field) {
+    return (char *)cold_field(h, field);
+}
+
+void history_row(const HistoryEntry *entry, HistoryRow *row) {
+    row->timestamp = entry->timestamp;
+    row->temp = entry->weather.temp;
+    for (int f = 0; f < COLD_FIELDS; f++) row->fields[f] = cold_field(entry, f);
+}
+
+static void put_varint(uint8_t *buf, size_t *pos, uint64_t v) {
+    while (v >= 0x80) {
+        buf[(*pos)++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    buf[(*pos)++] = (uint8_t)v;
+}
+
+static int get_varint(const uint8_t *buf, size_t len, size_t *pos, uint64_t *out) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64 && *pos < len; shift += 7) {
+        uint8_t b = buf[(*pos)++];
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *out = v;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static size_t lz_emit(uint8_t *out, size_t op, const uint8_t *literals, size_t lit_len, size_t offset, size_t match_len) {
+    size_t token_pos = op++;
+    uint8_t token = (uint8_t)((lit_len >= 15 ? 15 : lit_len) << 4);
+    if (lit_len >= 15) {
+        size_t rest = lit_len - 15;
+        for (; rest >= 255; rest -= 255) out[op++] = 255;
+        out[op++] = (uint8_t)rest;
+    }
+    memcpy(out + op, literals, lit_len);
+    op += lit_len;
+
+    if (match_len > 0) {
+        size_t rest = match_len - 4;
+        out[op++] = (uint8_t)(offset & 0xff);
+        out[op++] = (uint8_t)(offset >> 8);
+        token |= (uint8_t)(rest >= 15 ? 15 : rest);
+        if (rest >= 15) {
+            for (rest -= 15; rest >= 255; rest -= 255) out[op++] = 255;
+            out[op++] = (uint8_t)rest;
+        }
+    }
+    out[token_pos] = token;
+    return op;
+}
+
+// Compress n bytes; out needs n + n / 255 + 16 bytes. Returns the compressed size.
+static size_t lz_compress(const uint8_t *in, size_t n, uint8_t *out) {
+    uint32_t table[1 << LZ_HASH_BITS]; // Position + 1 of the last 4-byte sequence per hash
+    size_t ip = 0, anchor = 0, op = 0;
+    memset(table, 0, sizeof(table));
+
+    while (ip + 12 <= n) {
+        uint32_t seq;
+        memcpy(&seq, in + ip, 4);
+        uint32_t h = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+        size_t ref = table[h];
+        table[h] = (uint32_t)(ip + 1);
+
+        if (ref && ip - (ref - 1) <= 65535 && memcmp(in + ref - 1, in + ip, 4) == 0) {
+            ref--;
+            size_t len = 4;
+            while (ip + len < n - 5 && in[ref + len] == in[ip + len]) len++;
+            op = lz_emit(out, op, in + anchor, ip - anchor, ip - ref, len);
+            ip += len;
+            anchor = ip;
+        } else {
+            ip++;
+        }
+    }
+    return lz_emit(out, op, in + anchor, n - anchor, 0, 0);
+}
+
+// Decompress into out (exactly out_len bytes expected); returns 0 on success
+static int lz_decompress(const uint8_t *in, size_t in_len, uint8_t *out, size_t out_len) {
+    size_t ip = 0, op = 0;
+    while (ip < in_len) {
+        uint8_t token = in[ip++];
+        size_t lit = token >> 4;
+        if (lit == 15) {
+            uint8_t b;
+            do {
+                if (ip >= in_len) return -1;
+                b = in[ip++];
+                lit += b;
+            } while (b == 255);
+        }
+        if (lit > in_len - ip || lit > out_len - op) return -1;
+        memcpy(out + op, in + ip, lit);
+        ip += lit;
+        op += lit;
+        if (ip == in_len) break;
+
+        if (in_len - ip < 2) return -1;
+        size_t offset = in[ip] | (size_t)in[ip + 1] << 8;
+        ip += 2;
+        size_t len = token & 15;
+        if (len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= in_len) return -1;
+                b = in[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        len += 4;
+        if (offset == 0 || offset > op || len > out_len - op) return -1;
+        if (offset >= len) {
+            memcpy(out + op, out + op - offset, len);
+        } else {
+            for (size_t i = 0; i < len; i++) out[op + i] = out[op + i - offset]; // Overlapping run
+        }
+        op += len;
+    }
+    return op == out_len ? 0 : -1;
+}
+
+// Encode rows into the uncompressed segment layout; returns the size
+static size_t encode_cold_rows(const HistoryEntry *rows, int count, uint8_t *buf) {
+    // Per-segment string dictionary (open addressing over pointers into rows)
+    int slot_count = 1;
+    while (slot_count < count * COLD_FIELDS * 2) slot_count <<= 1;
+    int *slots = malloc(slot_count * sizeof(int));
+    const char **strings = malloc((size_t)count * COLD_FIELDS * sizeof(char *));
+    uint32_t *ids = malloc((size_t)count * COLD_FIELDS * sizeof(uint32_t));
+    size_t pos = 0;
+    if (!slots || !strings || !ids) {
+        free(slots);
+        free(strings);
+        free(ids);
+        return 0;
+    }
+    memset(slots, -1, slot_count * sizeof(int));
+
+    uint32_t string_count = 0;
+    for (int r = 0; r < count; r++) {
+        for (int f = 0; f < COLD_FIELDS; f++) {
+            const char *str = cold_field(&rows[r], f);
+            unsigned slot = fnv1a32(str, strlen(str)) & (slot_count - 1);
+            while (slots[slot] >= 0 && strcmp(strings[slots[slot]], str) != 0) slot = (slot + 1) & (slot_count - 1);
+            if (slots[slot] < 0) {
+                slots[slot] = (int)string_count;
+                strings[string_count++] = str;
+            }
+            ids[(size_t)f * count + r] = (uint32_t)slots[slot];
+        }
+    }
+
+    memcpy(buf, &string_count, 4);
+    pos = 4;
+    for (uint32_t i = 0; i < string_count; i++) {
+        size_t len = strnlen(strings[i], MAX_LEN - 1);
+        buf[pos++] = (uint8_t)len;
+        memcpy(buf + pos, strings[i], len);
+        pos += len;
+    }
+
+    put_varint(buf, &pos, zigzag(rows[0].timestamp));
+    for (int r = 1; r < count; r++) put_varint(buf, &pos, zigzag(rows[r].timestamp - rows[r - 1].timestamp));
+    for (int r = 0; r < count; r++) {
+        float tenths = rows[r].weather.temp * 10.0f;
+        put_varint(buf, &pos, zigzag((int64_t)(tenths < 0 ? tenths - 0.5f : tenths + 0.5f)));
+    }
+    for (size_t i = 0; i < (size_t)count * COLD_FIELDS; i++) put_varint(buf, &pos, ids[i]);
+
+    free(slots);
+    free(strings);
+    free(ids);
+    return pos;
+}
+
+static int add_cold_segment(const ColdSegment *seg) {
+    if (cold_segment_count == cold_segment_capacity) {
+        int cap = cold_segment_capacity ? cold_segment_capacity * 2 : 16;
+        ColdSegment *segs = realloc(cold_segments, cap * sizeof(ColdSegment));
+        if (!segs) return -1;
+        cold_segments = segs;
+        cold_segment_capacity = cap;
+    }
+    cold_segments[cold_segment_count++] = *seg;
+    return 0;
+}
+
+static int ensure_cold_staging() {
+    if (!cold_staging && !(cold_staging = malloc(COLD_SEGMENT_ROWS * sizeof(HistoryEntry)))) return -1;
+    return 0;
+}
+
+static int sync_and_close(FILE *fp, int ok) {
+    ok = ok && fflush(fp) == 0;
+#ifndef _WIN32
+    ok = ok && fsync(fileno(fp)) == 0;
+#endif
+    return (fclose(fp) == 0) && ok;
+}
+
+// Rewrite COLD_STAGING_FILE from the staging buffer (temp file + rename)
+static int write_cold_staging(int absorbed) {
+    if (!cold_staging_durable) return 0;
+    ColdStagingHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "HISTSTG", 8);
+    header.version = COLD_STAGING_VERSION;
+    header.segment = cold_staging_segment;
+    header.absorbed = absorbed;
+
+    char tmp_path[MAX_LEN];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", COLD_STAGING_FILE);
+    FILE *fp = fopen(tmp_path, "wb");
+    int ok = fp && fwrite(&header, sizeof(header), 1, fp) == 1 &&
+             (cold_staging_count == 0 ||
+              fwrite(cold_staging, sizeof(HistoryEntry), cold_staging_count, fp) == (size_t)cold_staging_count);
+    if (fp) ok = sync_and_close(fp, ok);
+    ok = ok && rename(tmp_path, COLD_STAGING_FILE) == 0;
+    if (!ok) {
+        remove(tmp_path);
+        printf(RED "Could not write %s\n" RESET, COLD_STAGING_FILE);
+        return -1;
+    }
+    return 0;
+}
+
+// Append one staged entry to COLD_STAGING_FILE
+static int append_cold_staging(const HistoryEntry *entry) {
+    FILE *fp = fopen(COLD_STAGING_FILE, "ab");
+    int ok = fp && fwrite(entry, sizeof(*entry), 1, fp) == 1;
+    if (fp) ok = sync_and_close(fp, ok);
+    if (!ok) printf(RED "Could not write %s\n" RESET, COLD_STAGING_FILE);
+    return ok ? 0 : -1;
+}
+
+// Load COLD_STAGING_FILE into the staging buffer; returns 1 if it was valid
+static int read_cold_staging(ColdStagingHeader *header) {
+    FILE *fp = fopen(COLD_STAGING_FILE, "rb");
+    if (!fp) return 0;
+    int ok = fread(header, sizeof(*header), 1, fp) == 1 && memcmp(header->magic, "HISTSTG", 8) == 0 &&
+             header->version == COLD_STAGING_VERSION;
+    // A torn last record (crash mid-append) fails the fread and is dropped
+    while (ok && cold_staging_count < COLD_SEGMENT_ROWS &&
+           fread(&cold_staging[cold_staging_count], sizeof(HistoryEntry), 1, fp) == 1)
+        cold_staging_count++;
+    fclose(fp);
+    if (!ok) printf(RED "Ignoring invalid history staging file %s\n" RESET, COLD_STAGING_FILE);
+    return ok;
+}
+
+// Compress the staged entries into segment cold_staging_segment
+int cold_history_seal() {
+    int count = cold_staging_count;
+    if (count == 0) return 0;
+
+    size_t raw_cap = 4 + (size_t)count * COLD_FIELDS * MAX_LEN + (size_t)count * (10 + 10 + COLD_FIELDS * 5);
+    uint8_t *raw = malloc(raw_cap);
+    uint8_t *comp = malloc(raw_cap + raw_cap / 255 + 16);
+    size_t raw_size = raw && comp ? encode_cold_rows(cold_staging, count, raw) : 0;
+    if (raw_size == 0) {
+        free(raw);
+        free(comp);
+        return -1;
+    }
+
+    ColdSegmentHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "HISTSEG", 8);
+    header.version = COLD_SEGMENT_VERSION;
+    header.rows = (uint32_t)count;
+    header.min_timestamp = header.max_timestamp = cold_staging[0].timestamp;
+    for (int r = 1; r < count; r++) {
+        if (cold_staging[r].timestamp < header.min_timestamp) header.min_timestamp = cold_staging[r].timestamp;
+        if (cold_staging[r].timestamp > header.max_timestamp) header.max_timestamp = cold_staging[r].timestamp;
+    }
+    header.raw_size = (uint32_t)raw_size;
+    header.comp_size = (uint32_t)lz_compress(raw, raw_size, comp);
+
+    ColdSegment seg = {cold_staging_segment, header.rows, header.min_timestamp, header.max_timestamp,
+                       header.raw_size, header.comp_size};
+    char path[MAX_LEN + 16], tmp_path[MAX_LEN + 24];
+    snprintf(path, sizeof(path), "%s-%06d.seg", cold_segment_prefix, seg.number);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE *fp = fopen(tmp_path, "wb");
+    int ok = fp && fwrite(&header, sizeof(header), 1, fp) == 1 && fwrite(comp, 1, header.comp_size, fp) == header.comp_size;
+    if (fp) ok = sync_and_close(fp, ok);
+    ok = ok && rename(tmp_path, path) == 0 && add_cold_segment(&seg) == 0;
+    free(raw);
+    free(comp);
+    if (!ok) {
+        remove(tmp_path);
+        printf(RED "Could not write cold history segment %s\n" RESET, path);
+        return -1;
+    }
+    cold_staging_count = 0;
+    cold_staging_segment = seg.number + 1;
+    write_cold_staging(0); // If this fails, startup sees the segment exists and drops the stale copies
+    return 0;
+}
+
+// Move an entry evicted from the hot tier into cold storage
+int cold_history_append(const HistoryEntry *entry) {
+    if (ensure_cold_staging() != 0) return -1;
+    if (cold_staging_count == COLD_SEGMENT_ROWS && cold_history_seal() != 0) return -1; // An earlier seal failed
+    cold_staging[cold_staging_count++] = *entry;
+    if (cold_staging_durable && append_cold_staging(entry) != 0) return -1;
+    return cold_staging_count == COLD_SEGMENT_ROWS ? cold_history_seal() : 0;
+}
+
+// Fully decoded columns of one cold segment
+typedef struct {
+    uint32_t rows;
+    uint8_t *raw;              // Decompressed block; strings point into it
+    const char **strings;      // NUL-terminated in place of each length byte
+    uint8_t *lengths;
+    uint32_t string_count;
+    int64_t *timestamps;
+    float *temps;
+    uint32_t *ids;             // ids[field * rows + row]
+} ColdSegmentData;
+
+static void free_cold_segment_data(ColdSegmentData *d) {
+    free(d->raw);
+    free(d->strings);
+    free(d->lengths);
+    free(d->timestamps);
+    free(d->temps);
+    free(d->ids);
+    memset(d, 0, sizeof(*d));
+}
+
+static int load_cold_segment_data(const ColdSegment *seg, ColdSegmentData *d) {
+    char path[MAX_LEN + 16];
+    snprintf(path, sizeof(path), "%s-%06d.seg", cold_segment_prefix, seg->number);
+    memset(d, 0, sizeof(*d));
+    d->rows = seg->rows;
+
+    FILE *fp = fopen(path, "rb");
+    uint8_t *comp = malloc(seg->comp_size ? seg->comp_size : 1);
+    d->raw = malloc(seg->raw_size ? seg->raw_size : 1);
+    int ok = fp && comp && d->raw && fseek(fp, sizeof(ColdSegmentHeader), SEEK_SET) == 0 &&
+             fread(comp, 1, seg->comp_size, fp) == seg->comp_size &&
+             lz_decompress(comp, seg->comp_size, d->raw, seg->raw_size) == 0 && seg->raw_size >= 4;
+    if (fp) fclose(fp);
+    free(comp);
+
+    // String table
+    size_t pos = 4;
+    if (ok) {
+        memcpy(&d->string_count, d->raw, 4);
+        d->strings = malloc((d->string_count ? d->string_count : 1) * sizeof(*d->strings));
+        d->lengths = malloc(d->string_count ? d->string_count : 1);
+        ok = d->strings && d->lengths;
+        for (uint32_t i = 0; ok && i < d->string_count; i++) {
+            ok = pos < seg->raw_size && pos + 1 + d->raw[pos] <= seg->raw_size;
+            if (!ok) break;
+            // Shift the bytes over their length prefix to end them with a NUL
+            uint8_t len = d->raw[pos];
+            memmove(d->raw + pos, d->raw + pos + 1, len);
+            d->raw[pos + len] = '\0';
+            d->lengths[i] = len;
+            d->strings[i] = (const char *)d->raw + pos;
+            pos += 1 + len;
+        }
+    }
+
+    // Columns
+    size_t n = d->rows ? d->rows : 1;
+    d->timestamps = malloc(n * sizeof(int64_t));
+    d->temps = malloc(n * sizeof(float));
+    d->ids = malloc(n * COLD_FIELDS * sizeof(uint32_t));
+    ok = ok && d->timestamps && d->temps && d->ids;
+    uint64_t v = 0;
+    for (uint32_t r = 0; ok && r < d->rows; r++) {
+        ok = get_varint(d->raw, seg->raw_size, &pos, &v);
+        d->timestamps[r] = r == 0 ? unzigzag(v) : d->timestamps[r - 1] + unzigzag(v);
+    }
+    for (uint32_t r = 0; ok && r < d->rows; r++) {
+        ok = get_varint(d->raw, seg->raw_size, &pos, &v);
+        d->temps[r] = unzigzag(v) / 10.0f;
+    }
+    for (size_t i = 0; ok && i < (size_t)d->rows * COLD_FIELDS; i++) {
+        ok = get_varint(d->raw, seg->raw_size, &pos, &v);
+        d->ids[i] = (uint32_t)v;
+    }
+
+    if (!ok) {
+        printf(RED "History segment %s is unreadable\n" RESET, path);
+        free_cold_segment_data(d);
+        return -1;
+    }
+    return 0;
+}
+
+static void cold_segment_entry(const ColdSegmentData *d, uint32_t r, HistoryEntry *entry) {
+    memset(entry, 0, sizeof(*entry));
+    entry->timestamp = d->timestamps[r];
+    entry->weather.temp = d->temps[r];
+    for (int f = 0; f < COLD_FIELDS; f++) {
+        uint32_t id = d->ids[(size_t)f * d->rows + r];
+        if (id < d->string_count) memcpy(cold_field_dest(entry, f), d->strings[id], d->lengths[id]);
+    }
+}
+
+// Move a short trailing segment back into staging, ahead of the staged entries
+static int fold_cold_segment(const ColdSegment *seg) {
+    ColdSegmentData d;
+    if (load_cold_segment_data(seg, &d) != 0) return -1;
+    memmove(cold_staging + d.rows, cold_staging, cold_staging_count * sizeof(HistoryEntry));
+    for (uint32_t r = 0; r < d.rows; r++) cold_segment_entry(&d, r, &cold_staging[r]);
+    cold_staging_count += d.rows;
+    free_cold_segment_data(&d);
+
+    cold_staging_segment = seg->number;
+    if (write_cold_staging(1) != 0) {
+        cold_staging_count -= seg->rows;
+        memmove(cold_staging, cold_staging + seg->rows, cold_staging_count * sizeof(HistoryEntry));
+        cold_staging_segment = seg->number + 1;
+        return -1;
+    }
+    char path[MAX_LEN + 16];
+    snprintf(path, sizeof(path), "%s-%06d.seg", cold_segment_prefix, seg->number);
+    remove(path); // Superseded by the staging file; startup removes it again if this is interrupted
+    cold_segment_count--;
+    return 0;
+}
+
+// Restore the staging buffer and read the headers of every existing
+// segment (their data stays on disk). From here on, evicted entries are
+// also written to COLD_STAGING_FILE.
+int load_cold_segments() {
+    ColdStagingHeader staged;
+    char path[MAX_LEN + 16];
+    memset(&staged, 0, sizeof(staged));
+    if (ensure_cold_staging() != 0) return -1;
+    cold_staging_count = 0;
+    int valid = read_cold_staging(&staged);
+    if (valid && staged.absorbed) {
+        // The staged entries already include this short segment's rows
+        snprintf(path, sizeof(path), "%s-%06d.seg", cold_segment_prefix, staged.segment);
+        remove(path);
+    }
+
+    for (int number = 1;; number++) {
+        snprintf(path, sizeof(path), "%s-%06d.seg", cold_segment_prefix, number);
+        FILE *fp = fopen(path, "rb");
+        if (!fp) break;
+
+        ColdSegmentHeader h;
+        int ok = fread(&h, sizeof(h), 1, fp) == 1 && memcmp(h.magic, "HISTSEG", 8) == 0 &&
+                 h.version == COLD_SEGMENT_VERSION;
+        fclose(fp);
+        if (!ok) {
+            printf(RED "Skipping invalid history segment %s\n" RESET, path);
+            continue;
+        }
+        ColdSegment seg = {number, h.rows, h.min_timestamp, h.max_timestamp, h.raw_size, h.comp_size};
+        if (add_cold_segment(&seg) != 0) return -1;
+    }
+
+    int last = cold_segment_count ? cold_segments[cold_segment_count - 1].number : 0;
+    int sealed = valid && !staged.absorbed && staged.segment <= last && cold_staging_count > 0;
+    if (sealed) cold_staging_count = 0; // The seal finished but the reset did not
+    cold_staging_segment = last + 1;
+    cold_staging_durable = 1;
+
+    int rewrite = !valid || sealed || staged.absorbed || staged.segment != cold_staging_segment;
+    while (cold_segment_count > 0 &&
+           cold_segments[cold_segment_count - 1].rows + cold_staging_count < COLD_SEGMENT_ROWS &&
+           fold_cold_segment(&cold_segments[cold_segment_count - 1]) == 0)
+        rewrite = 0;
+    if (rewrite) write_cold_staging(0);
+    return cold_segment_count;
+}
+
+static void cold_segment_row(const ColdSegmentData *d, uint32_t r, HistoryRow *row) {
+    row->timestamp = d->timestamps[r];
+    row->temp = d->temps[r];
+    for (int f = 0; f < COLD_FIELDS; f++) {
+        uint32_t id = d->ids[(size_t)f * d->rows + r];
+        row->fields[f] = id < d->string_count ? d->strings[id] : "";
+    }
+}
+
+static long long scan_cold_segment(const ColdSegment *seg, int64_t from, int64_t to,
+                                   int (*visit)(const HistoryEntry *, void *), void *user, int *stop) {
+    ColdSegmentData d;
+    HistoryEntry entry;
+    long long matched = 0;
+    if (load_cold_segment_data(seg, &d) != 0) return 0;
+    for (uint32_t r = 0; r < d.rows && !*stop; r++) {
+        if (d.timestamps[r] < from || d.timestamps[r] > to) continue;
+        cold_segment_entry(&d, r, &entry);
+        matched++;
+        if (visit && !visit(&entry, user)) *stop = 1;
+    }
+    free_cold_segment_data(&d);
+    return matched;
+}
+
+// Visit archived entries with from <= timestamp <= to, oldest first.
+// visit returns 0 to stop early. Returns the number of entries visited.
+long long cold_history_scan(int64_t from, int64_t to, int (*visit)(const HistoryEntry *entry, void *user), void *user) {
+    long long matched = 0;
+    int stop = 0;
+    for (int i = 0; i < cold_segment_count && !stop; i++) {
+        const ColdSegment *seg = &cold_segments[i];
+        if (seg->max_timestamp < from || seg->min_timestamp > to) continue; // Pruned by the min/max index
+        matched += scan_cold_segment(seg, from, to, visit, user, &stop);
+    }
+    for (int i = 0; i < cold_staging_count && !stop; i++) {
+        if (cold_staging[i].timestamp < from || cold_staging[i].timestamp > to) continue;
+        matched++;
+        if (visit && !visit(&cold_staging[i], user)) stop = 1;
+    }
+    return matched;
+}
+
+// Like cold_history_scan(), but each row is handed over as column values
+// instead of a rebuilt HistoryEntry
+long long cold_history_scan_rows(int64_t from, int64_t to, int (*visit)(const HistoryRow *row, void *user), void *user) {
+    long long matched = 0;
+    int stop = 0;
+    HistoryRow row;
+    for (int i = 0; i < cold_segment_count && !stop; i++) {
+        const ColdSegment *seg = &cold_segments[i];
+        ColdSegmentData d;
+        if (seg->max_timestamp < from || seg->min_timestamp > to) continue;
+        if (load_cold_segment_data(seg, &d) != 0) continue;
+        for (uint32_t r = 0; r < d.rows && !stop; r++) {
+            if (d.timestamps[r] < from || d.timestamps[r] > to) continue;
+            cold_segment_row(&d, r, &row);
+            matched++;
+            if (visit && !visit(&row, user)) stop = 1;
+        }
+        free_cold_segment_data(&d);
+    }
+    for (int i = 0; i < cold_staging_count && !stop; i++) {
+        if (cold_staging[i].timestamp < from || cold_staging[i].timestamp > to) continue;
+        history_row(&cold_staging[i], &row);
+        matched++;
+        if (visit && !visit(&row, user)) stop = 1;
+    }
+    return matched;
+}
+
+// Archived entries with from <= timestamp <= to. Segments inside the range
+// are counted from their headers; only partly covered ones are decoded.
+long long cold_history_count(int64_t from, int64_t to) {
+    long long count = 0;
+    for (int i = 0; i < cold_segment_count; i++) {
+        const ColdSegment *seg = &cold_segments[i];
+        ColdSegmentData d;
+        if (seg->max_timestamp < from || seg->min_timestamp > to) continue;
+        if (seg->min_timestamp >= from && seg->max_timestamp <= to) {
+            count += seg->rows;
+            continue;
+        }
+        if (load_cold_segment_data(seg, &d) != 0) continue;
+        for (uint32_t r = 0; r < d.rows; r++) count += d.timestamps[r] >= from && d.timestamps[r] <= to;
+        free_cold_segment_data(&d);
+    }
+    for (int i = 0; i < cold_staging_count; i++)
+        count += cold_staging[i].timestamp >= from && cold_staging[i].timestamp <= to;
+    return count;
+}
+
+long long cold_history_rows() {
+    long long rows = cold_staging_count;
+    for (int i = 0; i < cold_segment_count; i++) rows += cold_segments[i].rows;
+    return rows;
+}
+
+long long cold_history_bytes() {
+    long long bytes = 0;
+    for (int i = 0; i < cold_segment_count; i++) bytes += sizeof(ColdSegmentHeader) + cold_segments[i].comp_size;
+    return bytes;
+}
+
+static int count_city_bytes(const HistoryRow *row, void *user) {
+    *(long long *)user += (long long)strlen(row->fields[HISTORY_FIELD_CITY]);
+    return 1;
+}
+
+// Archive rows synthetic entries and time the scans
+static int history_benchmark_rows(long long rows) {
+    const char *moods[] = {"happy", "energetic", "laid-back", ""};
+    const char *cities[] = {"London", "Sydney", "Tokyo", "Paris"};
+    const char *conds[] = {"Sunny", "Rainy", "Cloudy", "Snowy"};
+    Outfit *outfits[NUM_CATEGORIES] = {cold_outfits, moderate_outfits, hot_outfits};
+    HistoryEntry h;
+    uint32_t seed = 7;
+    int64_t ts = 1600000000;
+
+    double start = monotonic_seconds();
+    for (long long i = 0; i < rows; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int cat = (seed >> 8) % NUM_CATEGORIES;
+        memset(&h, 0, sizeof(h));
+        h.outfit = outfits[cat][(seed >> 12) % NUM_OUTFITS];
+        strcpy(h.accessory, catalog_item_name(catalog_item_id(ITEM_ACCESSORY, cat, (seed >> 16) % NUM_ACCESSORIES)));
+        strcpy(h.shoe, catalog_item_name(catalog_item_id(ITEM_SHOE, cat, (seed >> 18) % NUM_SHOES)));
+        strcpy(h.jacket, catalog_item_name(catalog_item_id(ITEM_JACKET, cat, (seed >> 20) % NUM_JACKETS)));
+        strcpy(h.weather.city, cities[(seed >> 22) % 4]);
+        strcpy(h.weather.condition, conds[(seed >> 24) % 4]);
+        strcpy(h.mood, moods[(seed >> 26) % 4]);
+        h.weather.temp = cat * 15.0f - 5.0f + (float)((seed >> 4) % 150) / 10.0f;
+        ts += 3600 + (seed >> 20) % 7200;
+        h.timestamp = ts;
+        if (cold_history_append(&h) != 0) return -1;
+    }
+    cold_history_seal();
+    double built = monotonic_seconds() - start;
+
+    long long city_bytes = 0;
+    start = monotonic_seconds();
+    long long visited = cold_history_scan_rows(INT64_MIN, INT64_MAX, count_city_bytes, &city_bytes);
+    double scanned = monotonic_seconds() - start;
+
+    int64_t mid = cold_segment_count ? cold_segments[cold_segment_count / 2].min_timestamp : 0;
+    start = monotonic_seconds();
+    long long counted = cold_history_count(mid, ts);
+    double count_time = monotonic_seconds() - start;
+
+    long long raw = 0;
+    for (int i = 0; i < cold_segment_count; i++) raw += cold_segments[i].raw_size;
+    printf(CYAN "\n--- Cold History Benchmark (%lld entries) ---\n" RESET, rows);
+    printf("Archived in %.3f s into %d segment(s): %.1f MB in memory -> %.2f MB on disk (%.0fx)\n", built,
+           cold_segment_count, (double)rows * sizeof(HistoryEntry) / 1e6, cold_history_bytes() / 1e6,
+           (double)rows * sizeof(HistoryEntry) / cold_history_bytes());
+    printf("Full scan: %lld entries in %.3f s (%.0f MB/s decompressed)\n", visited, scanned,
+           scanned > 0 ? raw / 1e6 / scanned : 0.0);
+    printf("Date-range count: %lld entries in %.4f s\n", counted, count_time);
+    return 0;
+}
+
+// Command-line check: archive synthetic entries into a scratch directory,
+// report size and scan speed, then delete them
+int run_history_benchmark(long long rows) {
+    char dir[MAX_LEN / 2];
+    if (make_scratch_dir(dir, sizeof(dir)) != 0) {
+        printf(RED "Could not create a scratch directory for the benchmark\n" RESET);
+        return -1;
+    }
+    snprintf(cold_segment_prefix, sizeof(cold_segment_prefix), "%s/%s", dir, COLD_SEGMENT_PREFIX);
+    int status = history_benchmark_rows(rows);
+
+    char path[MAX_LEN + 16];
+    for (int i = 0; i < cold_segment_count; i++) {
+        snprintf(path, sizeof(path), "%s-%06d.seg", cold_segment_prefix, cold_segments[i].number);
+        remove(path);
+    }
+    remove_scratch_dir(dir);
+    snprintf(cold_segment_prefix, sizeof(cold_segment_prefix), "%s", COLD_SEGMENT_PREFIX);
+    return status;
+}
+
+// =============================
+// GROUP RECOMMENDATIONS
+// =============================
+// Everything that does not depend on the person (weather fit, ratings,
+// default picks for the condition) is scored once for the shared catalog.
+// One pass over the category's items then adds each member's availability
+// and wear history, giving an item-major score matrix. Constraints are
+// solved on that matrix for the whole group at once: a matching outfit by
+// the highest total score, distinct jackets by regret-ordered assignment
+// with per-jacket capacity ceil(count / jackets).
+
+#define GROUP_MISSING_PENALTY 100.0f // Item the member lacks (used only when forced)
+
+typedef struct {
+    int member;
+    float regret;
+} JacketRegret;
+
+static int compare_regret(const void *a, const void *b) {
+    float ra = ((const JacketRegret *)a)->regret, rb = ((const JacketRegret *)b)->regret;
+    return (ra < rb) - (ra > rb);
+}
+
+// Best item of one kind for a member given a score column per item
+static int best_group_item(const float *scores, int count, int member, int kind, int category, float *best_score) {
+    int best = 0;
+    float top = -1e30f;
+    for (int i = 0; i < item_kind_count[kind]; i++) {
+        float sc = scores[(size_t)catalog_item_id(kind, category, i) * count + member];
+        if (sc > top) {
+            top = sc;
+            best = i;
+        }
+    }
+    if (best_score) *best_score = top;
+    return best;
+}
+
+int recommend_group(const GroupMember members[], int count, const Weather *weather, int flags, GroupAssignment out[]) {
+    if (count <= 0 || count > MAX_GROUP_SIZE) return -1;
+    int category = get_category_index(weather->temp);
+    int condition = get_condition_index(weather->condition);
+    int32_t today = current_day();
+
+    // Shared part of the score, once per catalog item
+    float base[CATALOG_ITEMS] = {0};
+    for (int kind = 0; kind < NUM_ITEM_KINDS; kind++)
+        base[catalog_item_id(kind, category, condition_picks[category][condition][kind])] += 1.0f;
+    catalog_enter();
+    for (int i = 0; i < NUM_OUTFITS; i++) {
+        int id = catalog_item_id(ITEM_OUTFIT, category, i), sum = 0, n = 0;
+        for (int r = 0; r < rating_count; r++) {
+            if (strcmp(ratings[r].outfit_name, catalog_item_name(id)) == 0) {
+                sum += ratings[r].rating;
+                n++;
+            }
+        }
+        if (n > 0) base[id] += (float)sum / n - 3.0f; // Above or below an average rating
+    }
+    catalog_exit();
+
+    // Per-member candidate sets, then the batched item-major scoring pass
+    ItemSet *candidates = malloc(count * sizeof(ItemSet));
+    float *scores = malloc((size_t)CATALOG_ITEMS * count * sizeof(float));
+    if (!candidates || !scores) {
+        free(candidates);
+        free(scores);
+        return -1;
+    }
+    for (int m = 0; m < count; m++)
+        candidates[m] = members[m].wardrobe ? wardrobe_candidates(members[m].wardrobe, category, today)
+                                            : weather_valid_items[category];
+
+    for (int kind = 0; kind < NUM_ITEM_KINDS; kind++) {
+        for (int i = 0; i < item_kind_count[kind]; i++) {
+            int id = catalog_item_id(kind, category, i);
+            float *column = scores + (size_t)id * count;
+            for (int m = 0; m < count; m++) {
+                const Wardrobe *w = members[m].wardrobe;
+                float sc = base[id];
+                if (!itemset_has(&candidates[m], id)) sc -= GROUP_MISSING_PENALTY;
+                if (w) sc -= 0.01f * (w->wear_count[id] > 100 ? 100 : w->wear_count[id]); // Favour less-worn items
+                column[m] = sc;
+            }
+        }
+    }
+
+    // Outfits: one for everyone, or each member's best
+    int shared_outfit = -1;
+    if (flags & GROUP_MATCHING_OUTFIT) {
+        float best_total = -1e30f;
+        for (int i = 0; i < NUM_OUTFITS; i++) {
+            const float *column = scores + (size_t)catalog_item_id(ITEM_OUTFIT, category, i) * count;
+            float total = 0.0f;
+            for (int m = 0; m < count; m++) total += column[m];
+            if (total > best_total) {
+                best_total = total;
+                shared_outfit = i;
+            }
+        }
+    }
+
+    for (int m = 0; m < count; m++) {
+        GroupAssignment *a = &out[m];
+        memset(a, 0, sizeof(*a));
+        a->outfit = shared_outfit >= 0 ? shared_outfit : best_group_item(scores, count, m, ITEM_OUTFIT, category, NULL);
+        a->accessory = best_group_item(scores, count, m, ITEM_ACCESSORY, category, NULL);
+        a->shoe = best_group_item(scores, count, m, ITEM_SHOE, category, NULL);
+        a->jacket = best_group_item(scores, count, m, ITEM_JACKET, category, NULL);
+        if (flags & GROUP_SHARED_PALETTE) a->color = condition_palettes[condition][m % PALETTE_COLORS];
+    }
+
+    // Jackets: members with the most to lose pick first, each jacket up to capacity
+    if (flags & GROUP_DISTINCT_JACKETS) {
+        int capacity = (count + NUM_JACKETS - 1) / NUM_JACKETS;
+        int used[NUM_JACKETS] = {0};
+        JacketRegret *order = malloc(count * sizeof(JacketRegret));
+        if (!order) {
+            free(candidates);
+            free(scores);
+            return -1;
+        }
+        for (int m = 0; m < count; m++) {
+            float first = -1e30f, second = -1e30f;
+            for (int j = 0; j < NUM_JACKETS; j++) {
+                float sc = scores[(size_t)catalog_item_id(ITEM_JACKET, category, j) * count + m];
+                if (sc > first) {
+                    second = first;
+                    first = sc;
+                } else if (sc > second) {
+                    second = sc;
+                }
+            }
+            order[m].member = m;
+            order[m].regret = first - second;
+        }
+        qsort(order, count, sizeof(JacketRegret), compare_regret);
+
+        for (int k = 0; k < count; k++) {
+            int m = order[k].member, pick = -1;
+            float top = -1e30f;
+            for (int j = 0; j < NUM_JACKETS; j++) {
+                float sc = scores[(size_t)catalog_item_id(ITEM_JACKET, category, j) * count + m];
+                if (used[j] < capacity && sc > top) {
+                    top = sc;
+                    pick = j;
+                }
+            }
+            out[m].jacket = pick;
+            used[pick]++;
+        }
+        free(order);
+    }
+
+    // Any assigned item outside the member's candidates has to be borrowed
+    for (int m = 0; m < count; m++) {
+        GroupAssignment *a = &out[m];
+        a->compromised = !itemset_has(&candidates[m], catalog_item_id(ITEM_OUTFIT, category, a->outfit)) ||
+                         !itemset_has(&candidates[m], catalog_item_id(ITEM_ACCESSORY, category, a->accessory)) ||
+                         !itemset_has(&candidates[m], catalog_item_id(ITEM_SHOE, category, a->shoe)) ||
+                         !itemset_has(&candidates[m], catalog_item_id(ITEM_JACKET, category, a->jacket));
+    }
+
+    free(candidates);
+    free(scores);
+    return 0;
+}
+
+void plan_group_outfits(const Weather *weather) {
+    char input[MAX_LEN];
+    printf(CYAN "\n--- Group Outfit Planner ---\n" RESET);
+    printf("How many people (including you, max %d)? ", MAX_GROUP_SIZE);
+    fgets(input, MAX_LEN, stdin);
+    int count = atoi(input);
+    if (count < 1 || count > MAX_GROUP_SIZE) {
+        printf(RED "Please enter a number between 1 and %d.\n" RESET, MAX_GROUP_SIZE);
+        return;
+    }
+
+    GroupMember *members = calloc(count, sizeof(GroupMember));
+    GroupAssignment *plan = malloc(count * sizeof(GroupAssignment));
+    if (!members || !plan) {
+        free(members);
+        free(plan);
+        printf(RED "Not enough memory for a group of %d.\n" RESET, count);
+        return;
+    }
+    strcpy(members[0].name, "You");
+    members[0].wardrobe = wardrobe;
+    if (count <= 10) {
+        for (int m = 1; m < count; m++) {
+            printf("Name of person %d: ", m + 1);
+            fgets(members[m].name, MAX_LEN, stdin);
+            strip_newline(members[m].name);
+        }
+    }
+    for (int m = 1; m < count; m++) {
+        if (members[m].name[0] == '\0') snprintf(members[m].name, MAX_LEN, "Guest %d", m);
+    }
+
+    int flags = 0;
+    printf("No two people in the same jacket (where possible)? (1: Yes, 2: No): ");
+    if (get_valid_choice(2) == 1) flags |= GROUP_DISTINCT_JACKETS;
+    printf("Everyone in the same outfit? (1: Yes, 2: No): ");
+    if (get_valid_choice(2) == 1) flags |= GROUP_MATCHING_OUTFIT;
+    printf("Coordinate colors from one palette? (1: Yes, 2: No): ");
+    if (get_valid_choice(2) == 1) flags |= GROUP_SHARED_PALETTE;
+
+    simulate_loading("Coordinating the group's outfits...");
+    if (recommend_group(members, count, weather, flags, plan) != 0) {
+        printf(RED "Could not plan the group's outfits.\n" RESET);
+        free(members);
+        free(plan);
+        return;
+    }
+
+    int category = get_category_index(weather->temp);
+    int shown = count < 50 ? count : 50, compromised = 0;
+    catalog_enter();
+    for (int m = 0; m < count; m++) compromised += plan[m].compromised;
+    for (int m = 0; m < shown; m++) {
+        const GroupAssignment *a = &plan[m];
+        printf(YELLOW "\n%s" RESET "%s%s%s\n", members[m].name, a->color ? " | Color: " : "", a->color ? a->color : "",
+               a->compromised ? " (needs to borrow an item)" : "");
+        printf("Outfit: %s | Accessory: %s | Shoes: %s | Jacket: %s\n",
+               catalog_item_name(catalog_item_id(ITEM_OUTFIT, category, a->outfit)),
+               catalog_item_name(catalog_item_id(ITEM_ACCESSORY, category, a->accessory)),
+               catalog_item_name(catalog_item_id(ITEM_SHOE, category, a->shoe)),
+               catalog_item_name(catalog_item_id(ITEM_JACKET, category, a->jacket)));
+    }
+    if (shown < count) printf("\n... and %d more people.\n", count - shown);
+    if (compromised > 0) printf(YELLOW "\n%d people need an item they don't have available.\n" RESET, compromised);
+
+    printf("\nWear your planned outfit today? (1: Yes, 2: No): ");
+    if (get_valid_choice(2) == 1) {
+        int ids[NUM_ITEM_KINDS] = {
+            catalog_item_id(ITEM_OUTFIT, category, plan[0].outfit), catalog_item_id(ITEM_ACCESSORY, category, plan[0].accessory),
+            catalog_item_id(ITEM_SHOE, category, plan[0].shoe), catalog_item_id(ITEM_JACKET, category, plan[0].jacket)
+        };
+        record_wear(wardrobe, ids, NUM_ITEM_KINDS, current_day());
+        log_event(EVENT_RECOMMENDATION, count, catalog_item_name(ids[0]), "group");
+    }
+    catalog_exit();
+    free(members);
+    free(plan);
+    wait_for_user();
+}
+
+// Command-line check: plan a group of random wardrobes and time it
+int run_group_benchmark(int count) {
+    if (count < 1 || count > MAX_GROUP_SIZE) {
+        printf(RED "Group size must be between 1 and %d\n" RESET, MAX_GROUP_SIZE);
+        return -1;
+    }
+    GroupMember *members = calloc(count, sizeof(GroupMember));
+    Wardrobe *wardrobes = malloc(count * sizeof(Wardrobe));
+    GroupAssignment *plan = malloc(count * sizeof(GroupAssignment));
+    if (!members || !wardrobes || !plan) {
+        free(members);
+        free(wardrobes);
+        free(plan);
+        return -1;
+    }
+
+    uint32_t seed = 11;
+    for (int m = 0; m < count; m++) {
+        init_wardrobe(&wardrobes[m]);
+        for (int id = 0; id < CATALOG_ITEMS; id++) {
+            seed = seed * 1103515245u + 12345u;
+            if ((seed >> 16) % 3 == 0) itemset_remove(&wardrobes[m].owned, id); // Owns about two thirds
+            wardrobes[m].wear_count[id] = (seed >> 8) % 20;
+        }
+        snprintf(members[m].name, MAX_LEN, "Member %d", m + 1);
+        members[m].wardrobe = &wardrobes[m];
+    }
+
+    Weather weather = {"London", 6.0f, "Rainy"};
+    int flags = GROUP_DISTINCT_JACKETS | GROUP_MATCHING_OUTFIT | GROUP_SHARED_PALETTE;
+    double start = monotonic_seconds();
+    int rc = recommend_group(members, count, &weather, flags, plan);
+    double elapsed = monotonic_seconds() - start;
+
+    if (rc == 0) {
+        int used[NUM_JACKETS] = {0}, compromised = 0;
+        for (int m = 0; m < count; m++) {
+            used[plan[m].jacket]++;
+            compromised += plan[m].compromised;
+        }
+        printf(CYAN "\n--- Group Benchmark (%d people) ---\n" RESET, count);
+        printf("Planned in %.3f ms; %d people need to borrow an item\n", elapsed * 1000.0, compromised);
+        printf("Jackets worn:");
+        for (int j = 0; j < NUM_JACKETS; j++) printf(" %d", used[j]);
+        printf("\n");
+    }
+    free(members);
+    free(wardrobes);
+    free(plan);
+    return rc;
+}
+
+// =============================
+// HOT-RELOADABLE CATALOG
+// =============================
+// Readers use the Catalog published in live_catalog. A watcher thread
+// polls CATALOG_FILE; when it changes, the file is parsed and validated on
+// that thread and only a complete, valid catalog is published, with one
+// atomic exchange. Readers bracket their use with catalog_enter() and
+// catalog_exit(), which only store the global epoch into (and clear) a
+// per-thread slot: no locks and no waiting on the writer. A replaced
+// catalog is retired with the epoch it was replaced in and freed by the
+// watcher once no reader slot holds that epoch or an older one.
+//
+// catalog.csv lines: kind,category,number,name[,item1,item2,item3]
+// e.g. "jacket,cold,2,Shearling Jacket" or
+//      "outfit,hot,1,Summer Cool,Linen Shirt,Cotton Shorts,Straw Hat".
+// Listed entries replace the compiled-in ones; the rest keep their defaults.
+// Each slot may be listed once, and every line, the last one included,
+// must end with a newline, so a file caught halfway through being written
+// is rejected. Editors should still write a temp file and rename it into
+// place. The watcher compares mtime to the nanosecond along with size and
+// inode. It never prints: the version it published is left for the main
+// loop to announce between prompts, and catalog_watch_stop() wakes it from
+// its poll interval through a condition variable.
+
+typedef struct {
+    _Atomic uint64_t epoch;   // 0 outside a read section
+    char pad[56];             // One cache line per reader
+} CatalogReader;
+
+static CatalogReader catalog_readers[MAX_CATALOG_READERS];
+static atomic_int catalog_reader_count;
+static atomic_int catalog_overflow_readers;  // Readers without a slot; reclamation waits for them
+static _Atomic uint64_t catalog_epoch = 1;
+static THREAD_LOCAL int catalog_slot = -1;
+static THREAD_LOCAL int catalog_depth = 0;
+static THREAD_LOCAL const Catalog *catalog_pinned = NULL; // Catalog of the outermost read section
+static Catalog *retired_catalogs = NULL;     // Watcher thread only
+static atomic_int catalog_watch_running;
+static atomic_uint catalog_update_pending;   // Version published but not yet announced, 0 if none
+static char catalog_path[MAX_LEN] = CATALOG_FILE;
+#ifndef _WIN32
+static pthread_t catalog_watcher;
+static pthread_mutex_t catalog_watch_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t catalog_watch_wake = PTHREAD_COND_INITIALIZER;
+#endif
+
+static void fill_builtin_catalog(Catalog *c) {
+    Outfit *outfits[NUM_CATEGORIES] = {cold_outfits, moderate_outfits, hot_outfits};
+    char (*acc[NUM_CATEGORIES])[MAX_LEN] = {cold_accessories, moderate_accessories, hot_accessories};
+    char (*shoe[NUM_CATEGORIES])[MAX_LEN] = {cold_shoes, moderate_shoes, hot_shoes};
+    char (*jacket[NUM_CATEGORIES])[MAX_LEN] = {cold_jackets, moderate_jackets, hot_jackets};
+    memset(c, 0, sizeof(*c));
+    for (int cat = 0; cat < NUM_CATEGORIES; cat++) {
+        memcpy(c->outfits[cat], outfits[cat], sizeof(c->outfits[cat]));
+        memcpy(c->accessories[cat], acc[cat], sizeof(c->accessories[cat]));
+        memcpy(c->shoes[cat], shoe[cat], sizeof(c->shoes[cat]));
+        memcpy(c->jackets[cat], jacket[cat], sizeof(c->jackets[cat]));
+    }
+}
+
+void init_catalog() {
+    fill_builtin_catalog(&catalog_store);
+    catalog_store.version = 1;
+}
+
+const Catalog* catalog_enter() {
+    if (catalog_depth++ == 0) {
+        if (catalog_slot < 0) {
+            int slot = atomic_fetch_add(&catalog_reader_count, 1);
+            catalog_slot = slot < MAX_CATALOG_READERS ? slot : MAX_CATALOG_READERS;
+        }
+        if (catalog_slot < MAX_CATALOG_READERS) atomic_store(&catalog_readers[catalog_slot].epoch, atomic_load(&catalog_epoch));
+        else atomic_fetch_add(&catalog_overflow_readers, 1);
+        catalog_pinned = atomic_load(&live_catalog);
+    }
+    return catalog_pinned; // Nested sections see the same catalog as the outer one
+}
+
+void catalog_exit() {
+    if (--catalog_depth > 0) return;
+    catalog_pinned = NULL;
+    if (catalog_slot < MAX_CATALOG_READERS) atomic_store_explicit(&catalog_readers[catalog_slot].epoch, 0, memory_order_release);
+    else atomic_fetch_sub(&catalog_overflow_readers, 1);
+}
+
+// Valid only inside a read section (or before the watcher has started);
+// inside one it is the catalog pinned by catalog_enter()
+const Catalog* current_catalog() {
+    if (catalog_depth > 0) return catalog_pinned;
+    return atomic_load_explicit(&live_catalog, memory_order_acquire);
+}
+
+// Free every retired catalog no reader can still be using
+static void reclaim_catalogs() {
+    if (!retired_catalogs || atomic_load(&catalog_overflow_readers) > 0) return;
+    uint64_t oldest = UINT64_MAX;
+    int readers = atomic_load(&catalog_reader_count);
+    if (readers > MAX_CATALOG_READERS) readers = MAX_CATALOG_READERS;
+    for (int i = 0; i < readers; i++) {
+        uint64_t e = atomic_load(&catalog_readers[i].epoch);
+        if (e != 0 && e < oldest) oldest = e;
+    }
+
+    Catalog **link = &retired_catalogs;
+    while (*link) {
+        Catalog *c = *link;
+        if (c->retired_epoch < oldest) {
+            *link = c->retired_next;
+            free(c);
+        } else {
+            link = &c->retired_next;
+        }
+    }
+}
+
+static int parse_catalog_kind(const char *name) {
+    const char *kinds[NUM_ITEM_KINDS] = {"outfit", "accessory", "shoe", "jacket"};
+    for (int k = 0; k < NUM_ITEM_KINDS; k++) {
+        if (compare_names_ci(name, kinds[k]) == 0) return k;
+    }
+    return -1;
+}
+
+static char *catalog_slot_name(Catalog *c, int kind, int cat, int index) {
+    if (kind == ITEM_OUTFIT) return c->outfits[cat][index].title;
+    if (kind == ITEM_ACCESSORY) return c->accessories[cat][index];
+    if (kind == ITEM_SHOE) return c->shoes[cat][index];
+    return c->jackets[cat][index];
+}
+
+// Build a catalog from the compiled-in one plus the file's entries.
+// Returns 0 if the result is complete and valid, -1 (with a message) if not.
+int parse_catalog_file(const char *path, Catalog *out) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        printf(RED "Cannot open catalog %s\n" RESET, path);
+        return -1;
+    }
+    fill_builtin_catalog(out);
+
+    char line[MAX_LEN * 6];
+    int line_no = 0, status = 0;
+    ItemSet listed = {{0}}; // Slots already set by an earlier line
+    while (status == 0 && fgets(line, sizeof(line), fp)) {
+        line_no++;
+        if (!strchr(line, '\n')) {
+            printf(RED "%s:%d: %s\n" RESET, path, line_no,
+                   feof(fp) ? "last line has no newline (file still being written?)" : "line too long");
+            status = -1;
+            break;
+        }
+        strip_newline(line);
+        size_t len = strlen(line);
+        if (len > 0 && line[len - 1] == '\r') line[--len] = '\0';
+        if (line[0] == '\0' || line[0] == '#' || strncmp(line, "kind,", 5) == 0) continue;
+
+        char fields[4 + NUM_ITEMS][MAX_LEN];
+        int f = 0, too_long = 0, too_many = 0;
+        for (const char *p = line;;) {
+            const char *comma = strchr(p, ',');
+            size_t n = comma ? (size_t)(comma - p) : strlen(p);
+            if (f == 4 + NUM_ITEMS) {
+                too_many = 1;
+                break;
+            }
+            if (n >= MAX_LEN) too_long = 1;
+            copy_csv_field(fields[f++], p, n);
+            if (!comma) break;
+            p = comma + 1;
+        }
+
+        int kind = parse_catalog_kind(fields[0]);
+        int cat = -1;
+        for (int c = 0; c < NUM_CATEGORIES && f >= 2; c++) {
+            if (compare_names_ci(fields[1], categories[c]) == 0) cat = c;
+        }
+        char *end = NULL;
+        long number = f >= 3 ? strtol(fields[2], &end, 10) : 0;
+        int is_number = f >= 3 && end != fields[2] && *end == '\0';
+        const char *problem = NULL;
+        if (too_many) problem = "too many fields";
+        else if (kind < 0) problem = "unknown kind (outfit, accessory, shoe or jacket)";
+        else if (cat < 0) problem = "unknown category (cold, moderate or hot)";
+        else if (!is_number) problem = "number is not a whole number";
+        else if (number < 1 || number > item_kind_count[kind]) problem = "number out of range";
+        else if (itemset_has(&listed, catalog_item_id(kind, cat, (int)number - 1))) problem = "slot already listed";
+        else if (too_long) problem = "name too long";
+        else if (f != (kind == ITEM_OUTFIT ? 4 + NUM_ITEMS : 4)) problem = kind == ITEM_OUTFIT ? "outfits need a name and 3 items" : "expected kind,category,number,name";
+        if (!problem) {
+            for (int i = 3; i < f; i++) {
+                if (fields[i][0] == '\0') problem = "empty name";
+            }
+        }
+        if (problem) {
+            printf(RED "%s:%d: %s\n" RESET, path, line_no, problem);
+            status = -1;
+            break;
+        }
 
-char cold_accessories[NUM_ACCESSORIES][MAX_LEN] = {"Wool Scarf", "Insulated Gloves", "Warm Beanie", "Fleece Headband", "Thermal Socks"};
-char moderate_accessories[NUM_ACCESSORIES][MAX_LEN] = {"Baseball Cap", "Stylish Watch", "Leather Belt", "Sunglasses", "Light Scarf"};
-char hot_accessories[NUM_ACCESSORIES][MAX_LEN] = {"Wide-Brim Hat", "Cooling Bandana", "UV Wristband", "Portable Fan", "Sweat Towel"};
+        int index = (int)number - 1;
+        itemset_add(&listed, catalog_item_id(kind, cat, index));
+        strcpy(catalog_slot_name(out, kind, cat, index), fields[3]);
+        if (kind == ITEM_OUTFIT) {
+            for (int i = 0; i < NUM_ITEMS; i++) strcpy(out->outfits[cat][index].items[i], fields[4 + i]);
+        }
+    }
+    fclose(fp);
+
+    // Names must stay unique within a kind and category (history and ratings refer to them by name)
+    for (int kind = 0; status == 0 && kind < NUM_ITEM_KINDS; kind++) {
+        for (int cat = 0; status == 0 && cat < NUM_CATEGORIES; cat++) {
+            for (int i = 0; status == 0 && i < item_kind_count[kind]; i++) {
+                for (int j = i + 1; j < item_kind_count[kind]; j++) {
+                    if (strcmp(catalog_slot_name(out, kind, cat, i), catalog_slot_name(out, kind, cat, j)) == 0) {
+                        printf(RED "%s: duplicate %s \"%s\" in %s\n" RESET, path, item_kind_names[kind],
+                               catalog_slot_name(out, kind, cat, i), categories[cat]);
+                        status = -1;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return status;
+}
 
-char cold_shoes[NUM_SHOES][MAX_LEN] = {"Waterproof Boots", "Insulated Sneakers", "Warm Chelsea Boots", "Snow Boots", "Thermal Loafers"};
-char moderate_shoes[NUM_SHOES][MAX_LEN] = {"Comfortable Sneakers", "Canvas Shoes", "Casual Loafers", "Walking Boots", "Slip-ons"};
-char hot_shoes[NUM_SHOES][MAX_LEN] = {"Breathable Sandals", "Flip-Flops", "Mesh Sneakers", "Water Shoes", "Ventilated Slip-ons"};
+// Parse, validate and publish a new catalog; the current one stays live on any error
+int catalog_reload(const char *path) {
+    Catalog *fresh = malloc(sizeof(Catalog));
+    if (!fresh) return -1;
+    if (parse_catalog_file(path, fresh) != 0) {
+        free(fresh);
+        return -1;
+    }
 
-char cold_jackets[NUM_JACKETS][MAX_LEN] = {"Thermal Jacket", "Wool Jacket", "Insulated Coat", "Snow Parka", "Thick Hoodie"};
-char moderate_jackets[NUM_JACKETS][MAX_LEN] = {"Bomber Jacket", "Fleece Jacket", "Blazer", "Windbreaker", "Thin Hoodie"};
-char hot_jackets[NUM_JACKETS][MAX_LEN] = {"Mesh Jacket", "Light Hoodie", "Open Shirt", "Sport Vest", "Cotton Kimono"};
+    fresh->version = current_catalog()->version + 1;
+    Catalog *old = atomic_exchange(&live_catalog, fresh);
+    if (old != &catalog_store) {
+        old->retired_epoch = atomic_fetch_add(&catalog_epoch, 1);
+        old->retired_next = retired_catalogs;
+        retired_catalogs = old;
+    } else {
+        atomic_fetch_add(&catalog_epoch, 1);
+    }
+    reclaim_catalogs();
+    return 0;
+}
 
-HistoryEntry history[MAX_HISTORY];
-int history_count = 0;
+#ifndef _WIN32
+static void *catalog_watcher_main(void *arg) {
+    struct stat last = {0};
+    (void)arg;
+    while (atomic_load(&catalog_watch_running)) {
+        struct stat st;
+        if (stat(catalog_path, &st) == 0 &&
+            (st.st_mtim.tv_sec != last.st_mtim.tv_sec || st.st_mtim.tv_nsec != last.st_mtim.tv_nsec ||
+             st.st_size != last.st_size || st.st_ino != last.st_ino)) {
+            last = st;
+            if (catalog_reload(catalog_path) == 0)
+                atomic_store(&catalog_update_pending, current_catalog()->version); // Only this thread publishes
+        }
+        reclaim_catalogs();
+
+        // Sleep until the next poll, or until catalog_watch_stop() signals
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += CATALOG_POLL_MS * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        pthread_mutex_lock(&catalog_watch_lock);
+        while (atomic_load(&catalog_watch_running) &&
+               pthread_cond_timedwait(&catalog_watch_wake, &catalog_watch_lock, &deadline) == 0);
+        pthread_mutex_unlock(&catalog_watch_lock);
+    }
+    return NULL;
+}
+#endif
 
-OutfitRating ratings[100];  // Store up to 100 ratings
-int rating_count = 0;
+// Watch a catalog file and republish it whenever it changes
+int catalog_watch_start(const char *path) {
+    if (atomic_load(&catalog_watch_running)) return 0;
+    strncpy(catalog_path, path, MAX_LEN - 1);
+    catalog_path[MAX_LEN - 1] = '\0';
+    atomic_store(&catalog_watch_running, 1);
+#ifndef _WIN32
+    if (pthread_create(&catalog_watcher, NULL, catalog_watcher_main, NULL) != 0) {
+        atomic_store(&catalog_watch_running, 0);
+        return -1;
+    }
+#else
+    FILE *fp = fopen(catalog_path, "r");
+    if (fp) {
+        fclose(fp);
+        if (catalog_reload(catalog_path) == 0) // No watcher thread here: loaded once at startup
+            atomic_store(&catalog_update_pending, current_catalog()->version);
+    }
+#endif
+    return 0;
+}
 
-FavoriteOutfit favorites[MAX_FAVORITES];
-int favorite_count = 0;
+void catalog_watch_stop() {
+#ifndef _WIN32
+    pthread_mutex_lock(&catalog_watch_lock);
+    int was_running = atomic_exchange(&catalog_watch_running, 0);
+    pthread_cond_signal(&catalog_watch_wake);
+    pthread_mutex_unlock(&catalog_watch_lock);
+    if (!was_running) return;
+    pthread_join(catalog_watcher, NULL);
+#else
+    if (!atomic_exchange(&catalog_watch_running, 0)) return;
+#endif
+    reclaim_catalogs();
+}
 
-const char *seasons[NUM_SEASONS] = {"Spring", "Summer", "Fall", "Winter"};
-SpecialEvent special_events[NUM_SPECIAL_EVENTS] = {
-    {"Holiday Party", "Festive gathering with family and friends", 
-     "Elegant dress or suit with seasonal accessories", 
-     "Rich reds, deep greens, and metallic accents"},
-    {"Beach Day", "Perfect for summer relaxation", 
-     "Light, breathable fabrics with UV protection", 
-     "Bright colors and tropical patterns"},
-    {"Fall Festival", "Outdoor celebration with seasonal activities", 
-     "Layered clothing with comfortable footwear", 
-     "Warm earth tones and autumn colors"},
-    {"Spring Garden Party", "Outdoor social gathering", 
-     "Light layers with floral patterns", 
-     "Pastel colors and fresh spring tones"},
-    {"Winter Sports Day", "Active outdoor winter activities", 
-     "Thermal layers with waterproof outerwear", 
-     "Bright colors for visibility in snow"}
-};
+// Main loop: announce a catalog the watcher published since the last prompt
+void report_catalog_updates() {
+    unsigned version = atomic_exchange(&catalog_update_pending, 0);
+    if (version) printf(GREEN "\n[Catalog updated to version %u]\n" RESET, version);
+}
 
 // =============================
-// FUNCTION DECLARATIONS
+// PAGINATED VIEWS
 // =============================
+// History is listed newest first across the hot tier, the cold staging
+// buffer and the cold segments (newest segment first, pruned by min/max
+// timestamp). Its cursor is a (timestamp, rank within that timestamp)
+// pair, so it stays valid while new entries push old ones into cold
+// storage. Ratings are append-only, so their cursor is an array index.
+// Favorites are also keyed by index and are renumbered when one is
+// removed; browse_pages() then moves every page start after it down one,
+// so each page keeps its first record. A page stops walking as soon as it has
+// one record beyond page_size, so the first screen costs the same however
+// much is stored.
+
+static int32_t timestamp_day(int64_t ts) {
+    return (int32_t)(ts >= 0 ? ts / 86400 : (ts - 86399) / 86400);
+}
 
-void print_banner();
-void display_greeting(); // Consolidated greeting function
-void display_seasonal_tip(); // New function declaration
-void strip_newline(char *str);
-void wait_for_user();
-int get_valid_choice(int max);
-void get_weather_input(Weather *weather);
-const char* get_category(float temp);
-void simulate_loading(const char *msg);
-void display_outfits(Outfit outfits[], int size);
-void display_options(char options[][MAX_LEN], int count);
-void recommend_outfit(const Weather *weather);
-void show_weather_tips(const char *condition);
-void suggest_color_style(const char *condition); // Part of main branch features
-void give_temperature_advice(float temp); // Part of main branch features
-void secret_feature(); // Part of main branch features
-void check_for_secret_code(); // Part of main branch features
-void show_help_section(); // Part of main branch features
-void main_menu(); // Part of main branch features
-void get_user_note(char *note); // User note feature
-void get_user_mood(char *mood); // NEW FEATURE: mood input
-void save_history(Outfit o, Weather w, const char *a, const char *s, const char *j, const char *user_note, const char *mood); // Updated
-void show_history();
-void print_divider();
-void repeat_menu();
-void farewell();
-void rate_outfit(const char *outfit_name); // New rating feature
-void show_ratings(); // New rating feature
-void display_fashion_affirmation(); // New minor feature
+static void reset_filter(RecordFilter *f) {
+    memset(f, 0, sizeof(*f));
+    f->from_day = INT32_MIN;
+    f->to_day = INT32_MAX;
+}
 
-void add_to_favorites(const Outfit *outfit, const char *accessory, const char *shoe, const char *jacket);
-void show_favorites();
-void remove_favorite(int index);
-void show_seasonal_suggestions();
-const char* get_current_season();
-void suggest_special_event_outfit();
+float average_outfit_rating(const char *title) {
+    int sum = 0, n = 0;
+    for (int r = 0; r < rating_count; r++) {
+        if (strcmp(ratings[r].outfit_name, title) == 0) {
+            sum += ratings[r].rating;
+            n++;
+        }
+    }
+    return n > 0 ? (float)sum / n : 0.0f;
+}
 
-void get_general_feedback(); // NEW FEATURE: General feedback function
-void display_random_tip(); // NEW FEATURE: Random tip function
+typedef struct {
+    const PageCursor *at;
+    const RecordFilter *filter;
+    int page_size;
+    int found;
+    int more;              // A matching record exists after the page
+    int64_t run_ts;        // Timestamp of the current run of equal timestamps
+    int run;               // Records walked in that run
+    int first_number;
+} HistoryPageWalk;
+
+// Returns 0 once the page is complete
+static int offer_history(HistoryPageWalk *w, const HistoryEntry *h) {
+    if (h->timestamp != w->run_ts) {
+        w->run_ts = h->timestamp;
+        w->run = 0;
+    }
+    w->run++;
+    if (h->timestamp > w->at->key || (h->timestamp == w->at->key && w->run <= w->at->skip)) return 1;
 
+    const RecordFilter *f = w->filter;
+    int32_t day = timestamp_day(h->timestamp);
+    if (day < f->from_day || day > f->to_day) return 1;
+    if (f->city[0] && compare_names_ci(h->weather.city, f->city) != 0) return 1;
 
-// =============================
-// USER NOTE FEATURE IMPLEMENTATION
-// =============================
+    if (w->found == w->page_size) {
+        w->more = 1;
+        return 0;
+    }
+    print_history_entry(h, w->first_number + w->found);
+    w->found++;
+    return 1;
+}
 
-void get_user_note(char *note) {
-    printf("\n(Optional) Add a note about this outfit (e.g., occasion, mood, etc.): ");
-    fgets(note, MAX_LEN, stdin);
-    strip_newline(note);
+int render_history_page(const PageCursor *at, const RecordFilter *filter, int page_size, int first_number, PageCursor *next) {
+    HistoryPageWalk w = {at, filter, page_size, 0, 0, INT64_MIN, 0, first_number};
+    int64_t from = (int64_t)filter->from_day * 86400, to = (int64_t)filter->to_day * 86400 + 86399;
+    int going = 1;
+
+    for (int i = history_count - 1; i >= 0 && going; i--) going = offer_history(&w, &history[i]);
+    for (int i = cold_staging_count - 1; i >= 0 && going; i--) going = offer_history(&w, &cold_staging[i]);
+    for (int s = cold_segment_count - 1; s >= 0 && going; s--) {
+        const ColdSegment *seg = &cold_segments[s];
+        if (seg->min_timestamp > at->key || seg->max_timestamp < from || seg->min_timestamp > to) continue;
+        ColdSegmentData d;
+        HistoryEntry entry;
+        if (load_cold_segment_data(seg, &d) != 0) continue;
+        for (int r = (int)d.rows - 1; r >= 0 && going; r--) {
+            // Cheap skips on the timestamp column before decoding the row
+            if (d.timestamps[r] > at->key || d.timestamps[r] < from || d.timestamps[r] > to) continue;
+            cold_segment_entry(&d, r, &entry);
+            going = offer_history(&w, &entry);
+        }
+        free_cold_segment_data(&d);
+    }
+
+    next->end = !w.more;
+    if (w.more) {
+        // Resume at the record the walk stopped on
+        next->key = w.run_ts;
+        next->skip = w.run - 1;
+    }
+    return w.found;
 }
 
-// =============================
-// NEW FEATURE: MOOD INPUT IMPLEMENTATION
-// =============================
+int render_rating_page(const PageCursor *at, const RecordFilter *filter, int page_size, int first_number, PageCursor *next) {
+    int found = 0;
+    (void)first_number;
+    next->end = 1;
+    for (int64_t i = at->key < rating_count ? at->key : rating_count - 1; i >= 0; i--) {
+        const OutfitRating *r = &ratings[i];
+        int32_t day;
+        if (r->rating < filter->min_stars) continue;
+        if ((filter->from_day != INT32_MIN || filter->to_day != INT32_MAX) &&
+            (parse_calendar_date(r->date, &day) != 1 || day < filter->from_day || day > filter->to_day))
+            continue;
+        if (found == page_size) {
+            next->key = i;
+            next->end = 0;
+            break;
+        }
+        printf("\nOutfit: %s\n", r->outfit_name);
+        printf("Rating: ");
+        for (int j = 0; j < r->rating; j++) {
+            printf("★");
+        }
+        printf("\nDate: %s\n", r->date);
+        if (strlen(r->feedback) > 0) {
+            printf("Feedback: %s\n", r->feedback);
+        }
+        print_divider();
+        found++;
+    }
+    return found;
+}
 
-void get_user_mood(char *mood) {
-    printf("\n(Optional) How are you feeling today? (e.g., happy, energetic, laid-back): ");
-    fgets(mood, MAX_LEN, stdin);
-    strip_newline(mood);
+int render_favorite_page(const PageCursor *at, const RecordFilter *filter, int page_size, int first_number, PageCursor *next) {
+    int found = 0;
+    (void)first_number;
+    next->end = 1;
+    for (int64_t i = at->key; i < favorite_count; i++) {
+        const FavoriteOutfit *fav = &favorites[i];
+        if (filter->min_stars > 0 && average_outfit_rating(fav->outfit.title) < filter->min_stars) continue;
+        if (found == page_size) {
+            next->key = i;
+            next->end = 0;
+            break;
+        }
+        printf("\n%d. %s\n", (int)i + 1, fav->outfit.title);
+        printf("   Items:\n");
+        for (int j = 0; j < NUM_ITEMS; j++) {
+            printf("   - %s\n", fav->outfit.items[j]);
+        }
+        printf("   Accessory: %s\n", fav->accessory);
+        printf("   Shoes: %s\n", fav->shoe);
+        printf("   Jacket: %s\n", fav->jacket);
+        if (strlen(fav->note) > 0) {
+            printf("   Note: %s\n", fav->note);
+        }
+        print_divider();
+        found++;
+    }
+    return found;
+}
+
+static void prompt_filter(RecordFilter *f, int fields) {
+    char input[MAX_LEN];
+    reset_filter(f);
+    if (fields & FILTER_DATES) {
+        printf("Start date (YYYY-MM-DD, Enter for any): ");
+        fgets(input, MAX_LEN, stdin);
+        strip_newline(input);
+        if (input[0] && parse_calendar_date(input, &f->from_day) != 1) {
+            printf(RED "Invalid date, ignoring it.\n" RESET);
+            f->from_day = INT32_MIN;
+        }
+        printf("End date (YYYY-MM-DD, Enter for any): ");
+        fgets(input, MAX_LEN, stdin);
+        strip_newline(input);
+        if (input[0] && parse_calendar_date(input, &f->to_day) != 1) {
+            printf(RED "Invalid date, ignoring it.\n" RESET);
+            f->to_day = INT32_MAX;
+        }
+    }
+    if (fields & FILTER_STARS) {
+        printf("Minimum stars (1-5, Enter for any): ");
+        fgets(input, MAX_LEN, stdin);
+        f->min_stars = atoi(input);
+        if (f->min_stars < 0 || f->min_stars > 5) f->min_stars = 0;
+    }
+    if (fields & FILTER_CITY) {
+        printf("City (Enter for any): ");
+        fgets(f->city, MAX_LEN, stdin);
+        strip_newline(f->city);
+    }
+}
+
+// History view action: analytics over the whole history, nothing removed
+static int64_t browse_analytics() {
+    show_wardrobe_analytics();
+    return -1;
+}
+
+void browse_pages(const PagedView *view) {
+    RecordFilter filter;
+    int depth = 0, capacity = 16;
+    PageCursor *pages = malloc(capacity * sizeof(PageCursor)); // Start of every page visited so far
+    if (!pages) return;
+    reset_filter(&filter);
+    pages[0] = view->start;
+
+    while (1) {
+        PageCursor next;
+        printf(CYAN "\n--- %s (page %d) ---\n" RESET, view->title, depth + 1);
+        int shown = view->render(&pages[depth], &filter, PAGE_SIZE, depth * PAGE_SIZE + 1, &next);
+        if (shown == 0) printf(YELLOW "\nNothing matches on this page.\n" RESET);
+
+        int options = view->action ? 5 : 4;
+        printf("\n1. Next page\n2. Previous page\n3. Filter\n4. Back\n");
+        if (view->action) printf("5. %s\n", view->action_label);
+        int choice = get_valid_choice(options);
+
+        if (choice == 1) {
+            if (next.end) {
+                printf(YELLOW "\nThis is the last page.\n" RESET);
+                continue;
+            }
+            if (depth + 1 == capacity) {
+                PageCursor *grown = realloc(pages, capacity * 2 * sizeof(PageCursor));
+                if (!grown) continue;
+                pages = grown;
+                capacity *= 2;
+            }
+            pages[++depth] = next;
+        } else if (choice == 2) {
+            if (depth == 0) printf(YELLOW "\nThis is the first page.\n" RESET);
+            else depth--;
+        } else if (choice == 3) {
+            prompt_filter(&filter, view->filters);
+            depth = 0;
+        } else if (choice == 4) {
+            break;
+        } else {
+            // Records after a removed one moved down an index: move the page starts with them
+            int64_t removed = view->action();
+            for (int p = 0; removed >= 0 && p <= depth; p++)
+                if (pages[p].key > removed) pages[p].key--;
+        }
+    }
+    free(pages);
 }
 
 // =============================
 // MAIN FUNCTION
 // =============================
 
-int main() {
+int main(int argc, char *argv[]) {
     // Seed the random number generator
-    srand(time(NULL));
+    srand((unsigned) clock_now());
+    init_catalog();
+
+    // Batch mode: ./outfit_recommender --import observations.csv
+    if (argc >= 3 && strcmp(argv[1], "--import") == 0) {
+        return run_bulk_import(argv[2]) == 0 ? 0 : 1;
+    }
+    // Batch mode: ./outfit_recommender --build-climate observations.csv [climate.bin]
+    if (argc >= 3 && strcmp(argv[1], "--build-climate") == 0) {
+        return build_climate_table(argv[2], argc >= 4 ? argv[3] : CLIMATE_FILE) == 0 ? 0 : 1;
+    }
+
+    load_climate_table(CLIMATE_FILE); // Optional; enables instant default recommendations
+
+    // Instant mode: ./outfit_recommender --default "City"
+    if (argc >= 3 && strcmp(argv[1], "--default") == 0) {
+        show_climate_default(argv[2]);
+        return 0;
+    }
+    // Benchmark mode: ./outfit_recommender --bench-events 1000000
+    if (argc >= 3 && strcmp(argv[1], "--bench-events") == 0) {
+        return run_event_benchmark(atoll(argv[2])) == 0 ? 0 : 1;
+    }
+
+    // Integrity check: ./outfit_recommender --verify-snapshot [file]
+    if (argc >= 2 && strcmp(argv[1], "--verify-snapshot") == 0) {
+        return verify_snapshot(argc >= 3 ? argv[2] : SNAPSHOT_FILE) == 0 ? 0 : 1;
+    }
+
+    // Validation mode: ./outfit_recommender --check-catalog catalog.csv
+    if (argc >= 3 && strcmp(argv[1], "--check-catalog") == 0) {
+        Catalog *candidate = malloc(sizeof(Catalog));
+        int ok = candidate && parse_catalog_file(argv[2], candidate) == 0;
+        if (ok) printf(GREEN "%s is a valid catalog\n" RESET, argv[2]);
+        free(candidate);
+        return ok ? 0 : 1;
+    }
+    // Benchmark mode: ./outfit_recommender --bench-group 500
+    if (argc >= 3 && strcmp(argv[1], "--bench-group") == 0) {
+        init_catalog_sets();
+        refresh_date_context(NULL);
+        return run_group_benchmark(atoi(argv[2])) == 0 ? 0 : 1;
+    }
+    // Benchmark mode: ./outfit_recommender --bench-history 1000000
+    if (argc >= 3 && strcmp(argv[1], "--bench-history") == 0) {
+        return run_history_benchmark(atoll(argv[2])) == 0 ? 0 : 1;
+    }
+    // Benchmark mode: ./outfit_recommender --bench-analytics 100000000
+    if (argc >= 3 && strcmp(argv[1], "--bench-analytics") == 0) {
+        return run_analytics_benchmark(atoll(argv[2])) == 0 ? 0 : 1;
+    }
+
+    init_catalog_sets();
+    if (load_snapshot(SNAPSHOT_FILE) != 0) { // Restore history, ratings, favorites, catalog and wardrobe
+        init_wardrobe(wardrobe);
+    }
+    init_event_calendar();
+    load_cold_segments();      // Segment index plus the staged entries from COLD_STAGING_FILE
+    event_log_start(EVENT_LOG_PREFIX); // Feedback, ratings and favorites go to events-*.log
+    catalog_watch_start(CATALOG_FILE);  // Edits to catalog.csv go live without a restart
 
     while (1) {
         Weather current_weather;
+        refresh_date_context(NULL); // One date computation per request
+        report_catalog_updates();   // Reloads since the last menu, announced here rather than mid-prompt
         print_banner();
         display_greeting(); // Uses the consolidated greeting
         display_seasonal_tip(); // Call the new seasonal tip function
 
         display_random_tip(); // NEW FEATURE: Call the random tip function
-=======
-
-        printf("\n" CYAN "1. Get Outfit Recommendation\n2. View Past Recommendations\n3. View Outfit Ratings\n4. View Favorite Outfits\n5. Seasonal Suggestions\n6. Exit\n" RESET);
-        int choice = get_valid_choice(6);
-
-        if (choice == 6) break;
-        else if (choice == 5) show_seasonal_suggestions();
-        else if (choice == 4) show_favorites();
-        else if (choice == 3) show_ratings();
-        else if (choice == 2) show_history();
-        else {
-
 
         main_menu(); // Displays main menu options
         int choice; // Declare choice here
 
         // Use get_valid_choice with the correct max for the main menu
-        printf("\nEnter your choice (1-6, or 0 for Surprise Me!): "); // Adjusted prompt for main menu
-        if (scanf("%d", &choice) != 1 || (choice < 0 || choice > 6)) { // Check for valid input range for main menu
-            printf(RED "Invalid input. Please enter a number between 1 and 6, or 0 for Surprise Me!\n" RESET);
+        printf("\nEnter your choice (1-10, or 0 for Surprise Me!): "); // Adjusted prompt for main menu
+        if (scanf("%d", &choice) != 1 || (choice < 0 || choice > 10)) { // Check for valid input range for main menu
+            printf(RED "Invalid input. Please enter a number between 1 and 10, or 0 for Surprise Me!\n" RESET);
             while (getchar() != '\n'); // Clear invalid input
             continue; // Restart the loop
         }
         while (getchar() != '\n'); // Clear the newline character
 
-        if (choice == 6) { // Exit option (now 6)
+        if (choice == 10) { // Exit option (now 10)
             break;
+        } else if (choice == 9) { // Plan Group Outfits
+            get_weather_input(&current_weather);
+            refresh_date_context(current_weather.city);
+            plan_group_outfits(&current_weather);
+        } else if (choice == 8) { // Manage Wardrobe
+            manage_wardrobe();
         } else if (choice == 2) { // View History
             show_history();
         } else if (choice == 3) { // View Outfit Ratings
             show_ratings();
-        } else if (choice == 4) { // Help
+        } else if (choice == 4) { // View Favorite Outfits
+            show_favorites();
+        } else if (choice == 5) { // Seasonal Suggestions
+            show_seasonal_suggestions();
+        } else if (choice == 6) { // Help
             show_help_section();
-        } else if (choice == 5) { // Give Feedback
+        } else if (choice == 7) { // Give Feedback
             get_general_feedback();
         }
         else { // Get Outfit Recommendation (choice == 1 or 0 for surprise)
 
             get_weather_input(&current_weather);
+            refresh_date_context(current_weather.city); // Use the city's local date and season
             check_for_secret_code();
             simulate_loading("Analyzing weather and crafting your stylish fit...");
             recommend_outfit(&current_weather);
         }
 
+        save_snapshot_async(SNAPSHOT_FILE); // Persist in the background
         print_divider();
         repeat_menu();
         if (get_valid_choice(2) == 2) break;
     }
     farewell();
+    event_log_stop();
+    catalog_watch_stop();
+    save_snapshot_async(SNAPSHOT_FILE);
+    wait_for_snapshot();
     return 0;
 }
 
@@ -296,47 +4550,49 @@ int main() {
 // =============================
 
 void recommend_outfit(const Weather *weather) {
-    const char *category = get_category(weather->temp);
-
-    Outfit *outfits;
-    char (*accessories)[MAX_LEN];
-    char (*shoes)[MAX_LEN];
-    char (*jackets)[MAX_LEN];
-
-    if (strcmp(category, "cold") == 0) {
-        outfits = cold_outfits;
-        accessories = cold_accessories;
-        shoes = cold_shoes;
-        jackets = cold_jackets;
-    }
-    else if (strcmp(category, "moderate") == 0) {
-        outfits = moderate_outfits;
-        accessories = moderate_accessories;
-        shoes = moderate_shoes;
-        jackets = moderate_jackets;
-    }
-    else {
-        outfits = hot_outfits;
-        accessories = hot_accessories;
-        shoes = hot_shoes;
-        jackets = hot_jackets;
-    }
+    // The whole session sees one catalog version, even if a reload lands meanwhile
+    const Catalog *catalog = catalog_enter();
+    int cat = get_category_index(weather->temp);
+    const Outfit *outfits = catalog->outfits[cat];
+    const char (*accessories)[MAX_LEN] = catalog->accessories[cat];
+    const char (*shoes)[MAX_LEN] = catalog->shoes[cat];
+    const char (*jackets)[MAX_LEN] = catalog->jackets[cat];
+
+    // Only offer items the user owns, that are clean and weren't just worn
+    int32_t today = current_day();
+    ItemSet candidates = wardrobe_candidates(wardrobe, cat, today);
+    int avail[CATALOG_ITEMS], n;
 
     printf("\nChoose an outfit from the list below:\n");
-    display_outfits(outfits, NUM_OUTFITS);
-    int outfit_choice = get_valid_choice(NUM_OUTFITS) - 1;
+    n = list_candidates(&candidates, ITEM_OUTFIT, cat, avail);
+    for (int i = 0; i < n; i++) {
+        printf(YELLOW "%d. %s\n" RESET, i + 1, outfits[avail[i]].title);
+        for (int j = 0; j < NUM_ITEMS; j++) {
+            printf("    - %s\n", outfits[avail[i]].items[j]);
+        }
+    }
+    int outfit_choice = avail[get_valid_choice(n) - 1];
 
     printf("\nChoose an accessory:\n");
-    display_options(accessories, NUM_ACCESSORIES);
-    int acc_choice = get_valid_choice(NUM_ACCESSORIES) - 1;
+    n = list_candidates(&candidates, ITEM_ACCESSORY, cat, avail);
+    for (int i = 0; i < n; i++) printf("%d. %s\n", i + 1, accessories[avail[i]]);
+    int acc_choice = avail[get_valid_choice(n) - 1];
 
     printf("\nChoose a shoe option:\n");
-    display_options(shoes, NUM_SHOES);
-    int shoe_choice = get_valid_choice(NUM_SHOES) - 1;
+    n = list_candidates(&candidates, ITEM_SHOE, cat, avail);
+    for (int i = 0; i < n; i++) printf("%d. %s\n", i + 1, shoes[avail[i]]);
+    int shoe_choice = avail[get_valid_choice(n) - 1];
 
     printf("\nChoose a jacket:\n");
-    display_options(jackets, NUM_JACKETS);
-    int jacket_choice = get_valid_choice(NUM_JACKETS) - 1;
+    n = list_candidates(&candidates, ITEM_JACKET, cat, avail);
+    for (int i = 0; i < n; i++) printf("%d. %s\n", i + 1, jackets[avail[i]]);
+    int jacket_choice = avail[get_valid_choice(n) - 1];
+
+    int worn[NUM_ITEM_KINDS] = {
+        catalog_item_id(ITEM_OUTFIT, cat, outfit_choice), catalog_item_id(ITEM_ACCESSORY, cat, acc_choice),
+        catalog_item_id(ITEM_SHOE, cat, shoe_choice), catalog_item_id(ITEM_JACKET, cat, jacket_choice)
+    };
+    record_wear(wardrobe, worn, NUM_ITEM_KINDS, today);
 
     // User Note Feature
     char user_note[MAX_LEN] = "";
@@ -369,6 +4625,11 @@ void recommend_outfit(const Weather *weather) {
     give_temperature_advice(weather->temp);
     save_history(selected, *weather, accessories[acc_choice], shoes[shoe_choice], jackets[jacket_choice], user_note, mood);
 
+    char summary[EVENT_TEXT_LEN];
+    snprintf(summary, sizeof(summary), "%.40s|%.1f|%.40s|%.30s|%.30s|%.30s", weather->city, weather->temp,
+             weather->condition, accessories[acc_choice], shoes[shoe_choice], jackets[jacket_choice]);
+    log_event(EVENT_RECOMMENDATION, outfit_choice, selected.title, summary);
+
     printf("\nWould you like to:\n");
     printf("1. Rate this outfit\n");
     printf("2. Add to favorites\n");
@@ -382,6 +4643,7 @@ void recommend_outfit(const Weather *weather) {
     if (choice == 2 || choice == 3) {
         add_to_favorites(&selected, accessories[acc_choice], shoes[shoe_choice], jackets[jacket_choice]);
     }
+    catalog_exit();
 
     wait_for_user();
 }
@@ -397,10 +4659,8 @@ void print_banner() {
 
 // Consolidated greeting function with day and time-based messages
 void display_greeting() {
-    time_t t = time(NULL);
-    struct tm *tm_info = localtime(&t);
-    int hour = tm_info->tm_hour;
-    int wday = tm_info->tm_wday;
+    int hour = date_ctx.local.tm_hour;
+    int wday = date_ctx.local.tm_wday;
 
     const char *days[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
 
@@ -416,19 +4676,17 @@ void display_greeting() {
 
 // New function for seasonal tips
 void display_seasonal_tip() {
-    time_t t = time(NULL);
-    struct tm *tm_info = localtime(&t);
-    int month = tm_info->tm_mon; // 0-11 for Jan-Dec
+    int season = date_ctx.season; // Hemisphere-aware, from the date context
 
     printf(MAGENTA "\n--- Seasonal Style Tip ---\n" RESET);
 
-    if (month >= 2 && month <= 4) { // March, April, May (Spring)
+    if (season == 0) { // Spring
         printf("Spring is here! Embrace lighter layers and floral patterns.\n");
-    } else if (month >= 5 && month <= 7) { // June, July, August (Summer)
+    } else if (season == 1) { // Summer
         printf("Summer heat calls for breathable fabrics like linen and cotton. Stay cool!\n");
-    } else if (month >= 8 && month <= 10) { // September, October, November (Autumn)
+    } else if (season == 2) { // Autumn
         printf("Autumn leaves are falling! Layer up with knits and earthy tones.\n");
-    } else { // December, January, February (Winter)
+    } else { // Winter
         printf("Winter chill! Focus on warmth with wools, down, and insulated wear.\n");
     }
 }
@@ -439,6 +4697,15 @@ void strip_newline(char *str) {
     if (len > 0 && str[len - 1] == '\n') str[len - 1] = '\0';
 }
 
+// Case-insensitive strcmp() for cities, styles, catalog kinds and the like
+int compare_names_ci(const char *a, const char *b) {
+    while (*a && tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+        a++;
+        b++;
+    }
+    return tolower((unsigned char)*a) - tolower((unsigned char)*b);
+}
+
 void wait_for_user() {
     printf("\nPress Enter to continue...");
     int c;
@@ -476,6 +4743,18 @@ void get_weather_input(Weather *weather) {
     fgets(weather->city, MAX_LEN, stdin);
     strip_newline(weather->city);
 
+    // Known city: offer the climatology default instead of typing the weather
+    const ClimateCell *typical = lookup_climate(weather->city, clock_now());
+    if (typical) {
+        printf(CYAN "Typical weather now: %.1f°C, %s. Use it? (1: Yes, 2: Enter my own): " RESET,
+               typical->temp_mean, conditions[typical->condition]);
+        if (get_valid_choice(2) == 1) {
+            weather->temp = typical->temp_mean;
+            strcpy(weather->condition, conditions[typical->condition]);
+            return;
+        }
+    }
+
     while (1) {
         printf("Enter current temperature in Celsius (between %.1f and %.1f): ", MIN_TEMP, MAX_TEMP);
         if (scanf("%f", &weather->temp) == 1 && weather->temp >= MIN_TEMP && weather->temp <= MAX_TEMP) {
@@ -493,9 +4772,7 @@ void get_weather_input(Weather *weather) {
 }
 
 const char* get_category(float temp) {
-    if (temp < 15.0) return "cold";
-    else if (temp <= 30.0) return "moderate";
-    return "hot";
+    return categories[get_category_index(temp)];
 }
 
 void simulate_loading(const char *msg) {
@@ -600,21 +4877,22 @@ void show_help_section() {
     printf("6. Get seasonal style tips based on the current month!\n"); // Updated help
     printf("7. You can add notes and your mood to your outfit history.\n");
     printf("8. Rate your recommended outfits and view past ratings.\n");
+    printf("9. Plan coordinated outfits for a whole group from the main menu.\n");
     wait_for_user();
 }
 
 void main_menu() {
-
-    printf("\n" CYAN "Main Menu:\n1. Get Outfit Recommendation\n2. View Past Recommendations\n3. View Outfit Ratings\n4. View Favorite Outfits\n5. Exit\n" RESET);
-
-    printf("\n" CYAN "Main Menu:\n1. Get Outfit Recommendation\n2. View Past Recommendations\n3. View Outfit Ratings\n4. Help\n5. Give Feedback\n6. Exit\n" RESET);
+    printf("\n" CYAN "Main Menu:\n1. Get Outfit Recommendation\n2. View Past Recommendations\n3. View Outfit Ratings\n4. View Favorite Outfits\n5. Seasonal Suggestions\n6. Help\n7. Give Feedback\n8. Manage Wardrobe\n9. Plan Group Outfits\n10. Exit\n" RESET);
 }
 
 void save_history(Outfit o, Weather w, const char *a, const char *s, const char *j, const char *user_note, const char *mood) {
-    // If history is full, overwrite the oldest entry (circular buffer)
+    // If the hot tier is full, move the oldest entry to cold storage
     if (history_count >= MAX_HISTORY) {
-        history_count = 0; // Reset to the beginning to overwrite
+        cold_history_append(&history[0]);
+        memmove(&history[0], &history[1], (MAX_HISTORY - 1) * sizeof(HistoryEntry));
+        history_count = MAX_HISTORY - 1;
     }
+    memset(&history[history_count], 0, sizeof(HistoryEntry));
     history[history_count].outfit = o;
     strcpy(history[history_count].weather.city, w.city);
     history[history_count].weather.temp = w.temp;
@@ -632,34 +4910,40 @@ void save_history(Outfit o, Weather w, const char *a, const char *s, const char
         strncpy(history[history_count].mood, mood, MAX_LEN - 1);
     history[history_count].mood[MAX_LEN - 1] = '\0'; // Ensure null-termination
 
+    history[history_count].timestamp = (int64_t)date_ctx.now;
+    analytics_append(&history[history_count]);
     history_count++;
 }
 
 
+void print_history_entry(const HistoryEntry *h, int number) {
+    printf(YELLOW "\nEntry %d | City: %s | Temp: %.1f°C | Condition: %s\n" RESET, number,
+           h->weather.city, h->weather.temp, h->weather.condition);
+    printf("Outfit: %s\n", h->outfit.title);
+    for (int j = 0; j < NUM_ITEMS; j++) {
+        printf(" - %s\n", h->outfit.items[j]);
+    }
+    printf("Accessory: %s\n", h->accessory);
+    printf("Shoes: %s\n", h->shoe);
+    printf("Jacket: %s\n", h->jacket);
+    if (strlen(h->user_note) > 0)
+        printf("Note: %s\n", h->user_note);
+    if (strlen(h->mood) > 0)
+        printf("Mood: %s\n", h->mood);
+}
+
 void show_history() {
-    if (history_count == 0) {
+    long long archived = cold_history_rows();
+    if (history_count == 0 && archived == 0) {
         printf(RED "\nNo past recommendations found.\n" RESET);
         return;
     }
 
-    printf(CYAN "\n--- Past Recommendations ---\n" RESET);
-    for (int i = 0; i < history_count; i++) {
-        HistoryEntry h = history[i];
-        printf(YELLOW "\nEntry %d | City: %s | Temp: %.1f°C | Condition: %s\n" RESET, i + 1,
-               h.weather.city, h.weather.temp, h.weather.condition);
-        printf("Outfit: %s\n", h.outfit.title);
-        for (int j = 0; j < NUM_ITEMS; j++) {
-            printf(" - %s\n", h.outfit.items[j]);
-        }
-        printf("Accessory: %s\n", h.accessory);
-        printf("Shoes: %s\n", h.shoe);
-        printf("Jacket: %s\n", h.jacket);
-        if (strlen(h.user_note) > 0)
-            printf("Note: %s\n", h.user_note);
-        if (strlen(h.mood) > 0)
-            printf("Mood: %s\n", h.mood);
-    }
-    wait_for_user();
+    if (archived > cold_staging_count)
+        printf("\n%lld older recommendations are archived (%.1f KB on disk).\n", archived, cold_history_bytes() / 1024.0);
+    PagedView view = {"Past Recommendations", render_history_page, {INT64_MAX, 0, 0}, FILTER_DATES | FILTER_CITY,
+                      "Wardrobe analytics", browse_analytics};
+    browse_pages(&view);
 }
 
 void print_divider() {
@@ -677,7 +4961,7 @@ void farewell() {
 }
 
 void rate_outfit(const char *outfit_name) {
-    if (rating_count >= 100) {
+    if (rating_count >= MAX_RATINGS) {
         printf(RED "\nRating storage is full!\n" RESET);
         return;
     }
@@ -692,20 +4976,16 @@ void rate_outfit(const char *outfit_name) {
     strip_newline(feedback);
 
     // Get current date
-    time_t t = time(NULL);
-    struct tm *tm_info = localtime(&t);
     char date[MAX_LEN];
-    strftime(date, MAX_LEN, "%Y-%m-%d", tm_info);
+    strftime(date, MAX_LEN, "%Y-%m-%d", &date_ctx.local);
 
     // Save rating
     ratings[rating_count].rating = rating;
-    strncpy(ratings[rating_count].feedback, feedback, MAX_LEN - 1);
-    ratings[rating_count].feedback[MAX_LEN - 1] = '\0';
-    strncpy(ratings[rating_count].outfit_name, outfit_name, MAX_LEN - 1);
-    ratings[rating_count].outfit_name[MAX_LEN - 1] = '\0';
-    strncpy(ratings[rating_count].date, date, MAX_LEN - 1);
-    ratings[rating_count].date[MAX_LEN - 1] = '\0';
+    snprintf(ratings[rating_count].feedback, MAX_LEN, "%s", feedback);
+    snprintf(ratings[rating_count].outfit_name, MAX_LEN, "%s", outfit_name);
+    snprintf(ratings[rating_count].date, MAX_LEN, "%s", date);
     rating_count++;
+    log_event(EVENT_RATING, rating, outfit_name, feedback);
 
     printf(GREEN "\nThank you for your feedback!\n" RESET);
 }
@@ -716,20 +4996,8 @@ void show_ratings() {
         return;
     }
 
-    printf(CYAN "\n--- Outfit Ratings ---\n" RESET);
-    for (int i = 0; i < rating_count; i++) {
-        printf("\nOutfit: %s\n", ratings[i].outfit_name);
-        printf("Rating: ");
-        for (int j = 0; j < ratings[i].rating; j++) {
-            printf("★");
-        }
-        printf("\nDate: %s\n", ratings[i].date);
-        if (strlen(ratings[i].feedback) > 0) {
-            printf("Feedback: %s\n", ratings[i].feedback);
-        }
-        print_divider();
-    }
-    wait_for_user(); // Added to pause after showing ratings
+    PagedView view = {"Outfit Ratings", render_rating_page, {INT64_MAX, 0, 0}, FILTER_DATES | FILTER_STARS, NULL, NULL};
+    browse_pages(&view); // Newest first
 }
 
 // =============================
@@ -763,15 +5031,12 @@ void add_to_favorites(const Outfit *outfit, const char *accessory, const char *s
     strip_newline(note);
 
     favorites[favorite_count].outfit = *outfit;
-    strncpy(favorites[favorite_count].accessory, accessory, MAX_LEN - 1);
-    favorites[favorite_count].accessory[MAX_LEN - 1] = '\0';
-    strncpy(favorites[favorite_count].shoe, shoe, MAX_LEN - 1);
-    favorites[favorite_count].shoe[MAX_LEN - 1] = '\0';
-    strncpy(favorites[favorite_count].jacket, jacket, MAX_LEN - 1);
-    favorites[favorite_count].jacket[MAX_LEN - 1] = '\0';
-    strncpy(favorites[favorite_count].note, note, MAX_LEN - 1);
-    favorites[favorite_count].note[MAX_LEN - 1] = '\0';
+    snprintf(favorites[favorite_count].accessory, MAX_LEN, "%s", accessory);
+    snprintf(favorites[favorite_count].shoe, MAX_LEN, "%s", shoe);
+    snprintf(favorites[favorite_count].jacket, MAX_LEN, "%s", jacket);
+    snprintf(favorites[favorite_count].note, MAX_LEN, "%s", note);
     
+    log_event(EVENT_FAVORITE_ADDED, favorite_count, outfit->title, note);
     favorite_count++;
     printf(GREEN "\nOutfit added to favorites!\n" RESET);
 }
@@ -782,28 +5047,21 @@ void show_favorites() {
         return;
     }
 
-    printf(CYAN "\n--- Your Favorite Outfits ---\n" RESET);
-    for (int i = 0; i < favorite_count; i++) {
-        printf("\n%d. %s\n", i + 1, favorites[i].outfit.title);
-        printf("   Items:\n");
-        for (int j = 0; j < NUM_ITEMS; j++) {
-            printf("   - %s\n", favorites[i].outfit.items[j]);
-        }
-        printf("   Accessory: %s\n", favorites[i].accessory);
-        printf("   Shoes: %s\n", favorites[i].shoe);
-        printf("   Jacket: %s\n", favorites[i].jacket);
-        if (strlen(favorites[i].note) > 0) {
-            printf("   Note: %s\n", favorites[i].note);
-        }
-        print_divider();
-    }
+    PagedView view = {"Your Favorite Outfits", render_favorite_page, {0, 0, 0}, FILTER_STARS, "Remove a favorite",
+                      prompt_remove_favorite};
+    browse_pages(&view);
+}
 
-    printf("\nWould you like to remove any favorite? (1: Yes, 2: No): ");
-    if (get_valid_choice(2) == 1) {
-        printf("Enter the number of the outfit to remove (1-%d): ", favorite_count);
-        int choice = get_valid_choice(favorite_count);
-        remove_favorite(choice - 1);
+// Returns the index that was removed, or -1
+int64_t prompt_remove_favorite() {
+    if (favorite_count == 0) {
+        printf(YELLOW "\nNo favorite outfits left.\n" RESET);
+        return -1;
     }
+    printf("Enter the number of the outfit to remove (1-%d): ", favorite_count);
+    int choice = get_valid_choice(favorite_count);
+    remove_favorite(choice - 1);
+    return choice - 1;
 }
 
 void remove_favorite(int index) {
@@ -812,6 +5070,8 @@ void remove_favorite(int index) {
         return;
     }
 
+    log_event(EVENT_FAVORITE_REMOVED, index, favorites[index].outfit.title, favorites[index].note);
+
     // Shift remaining favorites up
     for (int i = index; i < favorite_count - 1; i++) {
         favorites[i] = favorites[i + 1];
@@ -821,14 +5081,7 @@ void remove_favorite(int index) {
 }
 
 const char* get_current_season() {
-    time_t t = time(NULL);
-    struct tm *tm_info = localtime(&t);
-    int month = tm_info->tm_mon + 1;  // tm_mon is 0-11
-
-    if (month >= 3 && month <= 5) return seasons[0];  // Spring
-    if (month >= 6 && month <= 8) return seasons[1];  // Summer
-    if (month >= 9 && month <= 11) return seasons[2]; // Fall
-    return seasons[3];  // Winter
+    return seasons[date_ctx.season]; // Looked up from season_table per hemisphere
 }
 
 void show_seasonal_suggestions() {
@@ -872,25 +5125,76 @@ void show_seasonal_suggestions() {
 
 void suggest_special_event_outfit() {
     printf(CYAN "\n--- Special Event Suggestions ---\n" RESET);
-    printf("Select an event type:\n");
-    for (int i = 0; i < NUM_SPECIAL_EVENTS; i++) {
-        printf("%d. %s\n", i + 1, special_events[i].name);
+    printf("Show events for:\n1. Today\n2. Another date\n");
+    int32_t day = current_day();
+    if (get_valid_choice(2) == 2) {
+        char input[MAX_LEN];
+        printf("Enter the date (YYYY-MM-DD): ");
+        fgets(input, MAX_LEN, stdin);
+        strip_newline(input);
+        if (parse_calendar_date(input, &day) != 1) {
+            printf(RED "Invalid date, using today.\n" RESET);
+            day = current_day();
+        }
     }
-    
-    int choice = get_valid_choice(NUM_SPECIAL_EVENTS) - 1;
-    printf("\n%s\n", special_events[choice].description);
-    printf("Suggested Outfit: %s\n", special_events[choice].outfit_suggestion);
-    printf("Color Scheme: %s\n", special_events[choice].color_scheme);
-    
+
+    int active[MAX_ACTIVE_EVENTS];
+    int count = find_active_events(day, active, MAX_ACTIVE_EVENTS);
+    if (count == 0) {
+        printf(YELLOW "\nNo events on that date.\n" RESET);
+        return;
+    }
+
+    printf("Select an event:\n");
+    for (int i = 0; i < count; i++) {
+        const CalendarEvent *e = &calendar_events[active[i]];
+        printf("%d. %s (%s%s)\n", i + 1, e->info.name, style_names[e->style], e->recurring ? ", yearly" : "");
+    }
+    const CalendarEvent *event = &calendar_events[active[get_valid_choice(count) - 1]];
+    printf("\n%s\n", event->info.description);
+    printf("Suggested Outfit: %s\n", event->info.outfit_suggestion);
+    printf("Color Scheme: %s\n", event->info.color_scheme);
+
+    // Build a real outfit from the event's style and the actual weather
+    Weather weather;
+    get_weather_input(&weather);
+    int cat = get_category_index(weather.temp);
+    const unsigned char *pick = condition_picks[cat][get_condition_index(weather.condition)];
+    int wanted[NUM_ITEM_KINDS] = {style_outfits[cat][event->style], pick[1], pick[2], pick[3]};
+    int chosen[NUM_ITEM_KINDS];
+
+    // Prefer the styled pick, otherwise the first available item of that kind
+    ItemSet candidates = wardrobe_candidates(wardrobe, cat, current_day());
+    for (int kind = 0; kind < NUM_ITEM_KINDS; kind++) {
+        int avail[CATALOG_ITEMS];
+        int n = list_candidates(&candidates, kind, cat, avail);
+        chosen[kind] = avail[0];
+        for (int i = 0; i < n; i++) {
+            if (avail[i] == wanted[kind]) chosen[kind] = wanted[kind];
+        }
+    }
+
+    const Catalog *catalog = catalog_enter();
+    const Outfit *outfit = &catalog->outfits[cat][chosen[ITEM_OUTFIT]];
+    const char *accessory = catalog->accessories[cat][chosen[ITEM_ACCESSORY]];
+    const char *shoe = catalog->shoes[cat][chosen[ITEM_SHOE]];
+    const char *jacket = catalog->jackets[cat][chosen[ITEM_JACKET]];
+
+    printf(GREEN "\n--- Your %s Outfit ---\n" RESET, event->info.name);
+    printf("Outfit: %s\n", outfit->title);
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        printf("- %s\n", outfit->items[i]);
+    }
+    printf("Accessory: %s\n", accessory);
+    printf("Shoes: %s\n", shoe);
+    printf("Jacket: %s\n", jacket);
+
     printf("\nWould you like to save this suggestion to favorites? (1: Yes, 2: No): ");
     if (get_valid_choice(2) == 1) {
-        Outfit special_outfit = {
-            special_events[choice].name,
-            {"Base Layer", "Main Piece", "Outer Layer"}
-        };
-        add_to_favorites(&special_outfit, "Event-specific accessory", 
-                        "Appropriate footwear", "Weather-appropriate outerwear");
+        add_to_favorites(outfit, accessory, shoe, jacket);
     }
+    catalog_exit();
+}
 
 // =============================
 // NEW FEATURE: GENERAL FEEDBACK
@@ -902,9 +5206,8 @@ void get_general_feedback() {
     fgets(feedback_text, sizeof(feedback_text), stdin);
     strip_newline(feedback_text);
 
+    log_event(EVENT_FEEDBACK, 0, "", feedback_text); // Persisted by the event log writer
     printf(GREEN "\nThank you for your valuable feedback! We appreciate you taking the time.\n" RESET);
-    // In a real application, this feedback would be saved to a file or sent to a server.
-    // For this example, we just acknowledge it.
     wait_for_user();
 }
 